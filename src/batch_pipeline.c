@@ -0,0 +1,191 @@
+/** @file
+ * Implementacja potokowego trybu wsadowego.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "batch_pipeline.h"
+#include "gamma_batch_mode.h"
+#include "spsc_ring.h"
+#include <pthread.h>
+
+/**
+ * Liczba miejsc w każdym z buforów między wątkami
+ */
+#define PIPELINE_CAPACITY 4096
+
+/**
+ * Typ elementu oznaczającego błędny wiersz wejścia
+ */
+#define PIPELINE_ERROR 'E'
+
+/**
+ * Liczba miejsc w buforze potwierdzeń wypisania planszy, silnik czeka na każde
+ */
+#define PIPELINE_BOARDS 1
+
+/**
+ * Typ elementu oznaczającego koniec wejścia
+ */
+#define PIPELINE_END EOF
+
+/** @brief Wczytane polecenie przekazywane silnikowi.
+ */
+typedef struct {
+    command current; ///< polecenie, typ @ref PIPELINE_ERROR lub @ref PIPELINE_END dla błędu i końca wejścia
+    long long line;  ///< numer wiersza polecenia
+} parsed_command;
+
+/** @brief Wynik polecenia przekazywany do wypisania.
+ * Dla polecenia p jest jedynie znacznikiem, planszę wypisuje wątek wypisujący.
+ */
+typedef struct {
+    int type;        ///< litera polecenia, @ref PIPELINE_ERROR lub @ref PIPELINE_END
+    long long line;  ///< numer wiersza błędnego polecenia
+    uint64_t value;  ///< wynik polecenia innego niż p
+} command_result;
+
+/** @brief Stan potoku współdzielony przez wątki.
+ */
+typedef struct {
+    gamma_t *g;                    ///< wskaźnik na strukturę przechowującą stan gry
+    long long current_line_count;  ///< liczba wierszy wczytanych przed trybem wsadowym
+    spsc_ring commands;            ///< polecenia od wątku czytającego dla silnika
+    spsc_ring results;             ///< wyniki od silnika dla wątku wypisującego
+    spsc_ring boards;              ///< potwierdzenia wypisania planszy od wątku wypisującego dla silnika
+} pipeline;
+
+/** @brief Wątek czytający polecenia z wejścia.
+ * Silnika używa jedynie do sprawdzenia, czy gra już istnieje.
+ */
+static void *parse_stage(void *context) {
+    pipeline *p = context;
+    long long current_line_count = p->current_line_count;
+    bool end_of_input = false;
+    parsed_command parsed;
+    while (!end_of_input) {
+        bool correct_command = true;
+
+        bool command_read = get_command(p->g, &parsed.current, &correct_command, &end_of_input);
+        current_line_count++;
+
+        if (!(correct_command && !command_read)) { // komentarz lub pusta
+            if (!correct_command) {
+                parsed.current.type = PIPELINE_ERROR;
+            }
+            parsed.line = current_line_count;
+            spsc_ring_push(&p->commands, &parsed);
+        }
+    }
+    parsed.current.type = PIPELINE_END;
+    spsc_ring_push(&p->commands, &parsed);
+    return NULL;
+}
+
+/** @brief Wątek wypisujący wyniki.
+ * Jako jedyny używa bufora wyjścia, więc kolejność wyników i błędów jest zachowana.
+ * Planszę wypisuje prosto ze stanu gry, tak jak zwykły tryb wsadowy, a silnik
+ * czeka z następnym poleceniem na potwierdzenie.
+ */
+static void *output_stage(void *context) {
+    pipeline *p = context;
+    const command print = {'p', {0}};
+    command_result result;
+    for (spsc_ring_pop(&p->results, &result); result.type != PIPELINE_END; spsc_ring_pop(&p->results, &result)) {
+        if (result.type == PIPELINE_ERROR) {
+            output_error(result.line);
+        } else if (result.type == 'b' || result.type == 'f') {
+            output_number(result.value);
+            output_char('\n');
+        } else if (result.type != 'p') {
+            output_char('0' + result.value);
+            output_char('\n');
+        } else {
+            execute_command(p->g, &print);
+            spsc_ring_push(&p->boards, &result.type);
+        }
+    }
+    output_flush();
+    return NULL;
+}
+
+/** @brief Wykonuje polecenia w wątku wywołującym, aż do końca wejścia.
+ */
+static void engine_stage(pipeline *p) {
+    gamma_t *g = p->g;
+    parsed_command parsed;
+    command_result result;
+    int printed;
+    do {
+        spsc_ring_pop(&p->commands, &parsed);
+        const uint32_t *argument = parsed.current.arguments;
+        result.type = parsed.current.type;
+        result.line = parsed.line;
+        if (result.type == 'm') {
+            result.value = gamma_move(g, argument[0], argument[1], argument[2]);
+        } else if (result.type == 'g') {
+            result.value = gamma_golden_move(g, argument[0], argument[1], argument[2]);
+        } else if (result.type == 'b') {
+            result.value = gamma_busy_fields(g, argument[0]);
+        } else if (result.type == 'f') {
+            result.value = gamma_free_fields(g, argument[0]);
+        } else if (result.type == 'q') {
+            result.value = gamma_golden_possible(g, argument[0]);
+        }
+        spsc_ring_push(&p->results, &result);
+        if (result.type == 'p') { // stan gry nie może się zmienić, dopóki plansza nie zostanie wypisana
+            spsc_ring_pop(&p->boards, &printed);
+        }
+    } while (result.type != PIPELINE_END);
+}
+
+void batch_pipeline(gamma_t *g, long long current_line_count) {
+    pipeline p;
+    p.g = g;
+    p.current_line_count = current_line_count;
+    if (!spsc_ring_init(&p.commands, PIPELINE_CAPACITY, sizeof(parsed_command))) {
+        batch_read_input(g, current_line_count);
+        return;
+    }
+    if (!spsc_ring_init(&p.results, PIPELINE_CAPACITY, sizeof(command_result))) {
+        spsc_ring_destroy(&p.commands);
+        batch_read_input(g, current_line_count);
+        return;
+    }
+    if (!spsc_ring_init(&p.boards, PIPELINE_BOARDS, sizeof(int))) {
+        spsc_ring_destroy(&p.commands);
+        spsc_ring_destroy(&p.results);
+        batch_read_input(g, current_line_count);
+        return;
+    }
+
+    pthread_t output_thread, parse_thread;
+    if (pthread_create(&output_thread, NULL, output_stage, &p) != 0) {
+        spsc_ring_destroy(&p.commands);
+        spsc_ring_destroy(&p.results);
+        spsc_ring_destroy(&p.boards);
+        batch_read_input(g, current_line_count);
+        return;
+    }
+    if (pthread_create(&parse_thread, NULL, parse_stage, &p) != 0) {
+        // nic jeszcze nie wczytano, więc kończymy wątek wypisujący i przechodzimy do zwykłego trybu
+        command_result end = {PIPELINE_END, 0, 0};
+        spsc_ring_push(&p.results, &end);
+        pthread_join(output_thread, NULL);
+        spsc_ring_destroy(&p.commands);
+        spsc_ring_destroy(&p.results);
+        spsc_ring_destroy(&p.boards);
+        batch_read_input(g, current_line_count);
+        return;
+    }
+
+    engine_stage(&p);
+
+    pthread_join(parse_thread, NULL);
+    pthread_join(output_thread, NULL);
+    spsc_ring_destroy(&p.commands);
+    spsc_ring_destroy(&p.results);
+    spsc_ring_destroy(&p.boards);
+}
@@ -0,0 +1,27 @@
+/** @file
+ * Interfejs potokowego trybu wsadowego.
+ * Wczytywanie poleceń, ich wykonywanie i wypisywanie wyników odbywa się
+ * w trzech wątkach połączonych buforami cyklicznymi, więc silnik nie czeka
+ * na wejście ani wyjście. Jedynie planszę wątek wypisujący wypisuje prosto
+ * ze stanu gry, bez tworzenia jej opisu w pamięci, więc silnik wstrzymuje się
+ * do końca jej wypisania. Wyniki i komunikaty o błędach są wypisywane
+ * w tej samej kolejności co w zwykłym trybie wsadowym.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_BATCH_PIPELINE_H
+#define GAMMA_BATCH_PIPELINE_H
+
+#include "gamma.h"
+
+/** @brief Obsługuje grę w trybie wsadowym w trzech wątkach.
+ * Gdy nie da się utworzyć wątków lub buforów, działa jak @ref batch_read_input.
+ * @param[in] *g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] current_line_count - liczba dotyczasowych linijek na wejściu
+ */
+void batch_pipeline(gamma_t *g, long long current_line_count);
+
+#endif /* GAMMA_BATCH_PIPELINE_H */
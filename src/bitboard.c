@@ -0,0 +1,58 @@
+/** @file
+ * Implementacja planszy bitowej dla małych plansz i niewielu graczy.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "bitboard.h"
+#include <string.h>
+
+void bitboard_init(bitboard *b, uint32_t width, uint32_t height) {
+    memset(b, 0, sizeof(*b));
+    b->height = height;
+    b->row_mask = width == BITBOARD_SIDE ? UINT64_MAX : (UINT64_C(1) << width) - 1;
+}
+
+/** @brief Podaje pola wiersza @p y sąsiadujące z polami zbioru.
+ * Wiersze spoza planszy są zerami, a kolumny spoza planszy odcina maska.
+ */
+static inline uint64_t adjacent_row(const bitboard *b, const bit_plane *plane, uint32_t y) {
+    uint64_t row = plane->rows[y + 1];
+    return (row << 1 | row >> 1 | plane->rows[y] | plane->rows[y + 2]) & b->row_mask;
+}
+
+uint64_t bitboard_frontier(const bitboard *b, uint32_t player, uint64_t rows[BITBOARD_SIDE]) {
+    const bit_plane *plane = &b->players[player - 1];
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < b->height; y++) {
+        uint64_t row = adjacent_row(b, plane, y) & ~b->occupied.rows[y + 1];
+        count += __builtin_popcountll(row);
+        if (rows != NULL) {
+            rows[y] = row;
+        }
+    }
+    return count;
+}
+
+uint64_t bitboard_contacts(const bitboard *b, uint32_t player, uint64_t rows[BITBOARD_SIDE]) {
+    const bit_plane *plane = &b->players[player - 1];
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < b->height; y++) {
+        uint64_t row = adjacent_row(b, plane, y) & b->occupied.rows[y + 1] & ~plane->rows[y + 1];
+        count += __builtin_popcountll(row);
+        if (rows != NULL) {
+            rows[y] = row;
+        }
+    }
+    return count;
+}
+
+uint64_t bitboard_count(const bitboard *b, const bit_plane *plane) {
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < b->height; y++) {
+        count += __builtin_popcountll(plane->rows[y + 1]);
+    }
+    return count;
+}
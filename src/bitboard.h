@@ -0,0 +1,92 @@
+/** @file
+ * Interfejs planszy bitowej dla małych plansz i niewielu graczy.
+ * Każdy wiersz planszy jest jednym słowem 64-bitowym, więc sąsiedztwo pól
+ * całego wiersza wyznacza kilka przesunięć, a liczbę pól – zliczenie bitów.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_BITBOARD_H
+#define GAMMA_BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Największa szerokość i wysokość planszy bitowej
+ */
+#define BITBOARD_SIDE 64
+
+/**
+ * Największa liczba graczy planszy bitowej
+ */
+#define BITBOARD_PLAYERS 8
+
+/** @brief Zbiór pól planszy, wiersz na słowo.
+ * Wiersz @p y zajmuje słowo @p y + 1, a skrajne słowa są zawsze zerami,
+ * więc sąsiednie wiersze da się odczytać bez sprawdzania brzegów.
+ */
+typedef struct {
+    uint64_t rows[BITBOARD_SIDE + 2]; ///< wiersze, bit @p x oznacza kolumnę @p x
+} bit_plane;
+
+/** @brief Plansza bitowa.
+ */
+typedef struct {
+    uint32_t height;                      ///< wysokość planszy
+    uint64_t row_mask;                    ///< bity kolumn leżących na planszy
+    bit_plane occupied;                   ///< pola zajęte przez któregokolwiek gracza
+    bit_plane players[BITBOARD_PLAYERS];  ///< pola kolejnych graczy, gracz 1 ma indeks 0
+} bitboard;
+
+/** @brief Inicjuje pustą planszę bitową.
+ * @param[out] b    – wskaźnik na planszę,
+ * @param[in] width  – szerokość planszy, nie większa od @ref BITBOARD_SIDE,
+ * @param[in] height – wysokość planszy, nie większa od @ref BITBOARD_SIDE.
+ */
+void bitboard_init(bitboard *b, uint32_t width, uint32_t height);
+
+/** @brief Zmienia właściciela pola (@p x, @p y).
+ * @param[in,out] b  – wskaźnik na planszę,
+ * @param[in] x, y   – współrzędne pola,
+ * @param[in] old_owner – dotychczasowy właściciel, 0 dla wolnego pola,
+ * @param[in] owner  – nowy właściciel, 0 dla wolnego pola.
+ */
+static inline void bitboard_set_owner(bitboard *b, uint32_t x, uint32_t y, uint32_t old_owner, uint32_t owner) {
+    uint64_t bit = UINT64_C(1) << x;
+    if (old_owner != 0) {
+        b->players[old_owner - 1].rows[y + 1] &= ~bit;
+        b->occupied.rows[y + 1] &= ~bit;
+    }
+    if (owner != 0) {
+        b->players[owner - 1].rows[y + 1] |= bit;
+        b->occupied.rows[y + 1] |= bit;
+    }
+}
+
+/** @brief Wyznacza wolne pola sąsiadujące z polami gracza.
+ * @param[in] b      – wskaźnik na planszę,
+ * @param[in] player – numer gracza, liczba dodatnia niewiększa od @ref BITBOARD_PLAYERS,
+ * @param[out] rows  – tablica na wiersze wyniku, może być NULL.
+ * @return liczba takich pól
+ */
+uint64_t bitboard_frontier(const bitboard *b, uint32_t player, uint64_t rows[BITBOARD_SIDE]);
+
+/** @brief Wyznacza pola innych graczy sąsiadujące z polami gracza.
+ * @param[in] b      – wskaźnik na planszę,
+ * @param[in] player – numer gracza, liczba dodatnia niewiększa od @ref BITBOARD_PLAYERS,
+ * @param[out] rows  – tablica na wiersze wyniku, może być NULL.
+ * @return liczba takich pól
+ */
+uint64_t bitboard_contacts(const bitboard *b, uint32_t player, uint64_t rows[BITBOARD_SIDE]);
+
+/** @brief Podaje liczbę pól zbioru.
+ * @param[in] b     – wskaźnik na planszę,
+ * @param[in] plane – wskaźnik na zbiór pól tej planszy.
+ * @return liczba pól
+ */
+uint64_t bitboard_count(const bitboard *b, const bit_plane *plane);
+
+#endif /* GAMMA_BITBOARD_H */
@@ -0,0 +1,203 @@
+/** @file
+ * Implementacja klasy obsługującej binarny zapis poleceń trybu wsadowego.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "command_stream.h"
+#include "gamma_batch_mode.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Napis rozpoczynający plik z poleceniami
+ */
+#define COMMAND_STREAM_MAGIC "GAMMACMD"
+
+/** @brief Dopisuje rekord do tworzonego pliku.
+ * @param[in] *file       – plik z poleceniami,
+ * @param[in] opcode      – kod rekordu,
+ * @param[in] *arguments  – trzy argumenty rekordu,
+ * @param[in, out] *count – liczba dotychczas zapisanych rekordów.
+ */
+static void write_record(FILE *file, uint32_t opcode, const uint32_t *arguments, uint64_t *count) {
+    command_record record;
+    record.opcode = opcode;
+    memcpy(record.arguments, arguments, sizeof(record.arguments));
+    fwrite(&record, sizeof(record), 1, file);
+    (*count)++;
+}
+
+/** @brief Dopisuje rekord, którego jedynym argumentem jest numer wiersza.
+ */
+static void write_line_record(FILE *file, uint32_t opcode, long long line, uint64_t *count) {
+    uint32_t arguments[3] = {(uint64_t)line & UINT32_MAX, (uint64_t)line >> 32, 0};
+    write_record(file, opcode, arguments, count);
+}
+
+/** @brief Odczytuje numer wiersza zapisany w rekordzie.
+ */
+static long long record_line(const command_record *record) {
+    return (long long)((uint64_t)record->arguments[1] << 32 | record->arguments[0]);
+}
+
+bool command_stream_compile(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    command_stream_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMMAND_STREAM_MAGIC, sizeof(header.magic));
+    header.version = COMMAND_STREAM_VERSION;
+    header.record_size = sizeof(command_record);
+    fwrite(&header, sizeof(header), 1, file); // liczba rekordów jest uzupełniana na końcu
+
+    gamma_t *g = NULL;
+    long long current_line_count = 0;
+    bool end_of_input = false;
+    bool interactive = false;
+    command current = {0, {0}};
+
+    // wiersze przed utworzeniem gry, tak jak w determine_game_type
+    while (!end_of_input && g == NULL) {
+        bool correct_command = true;
+
+        bool command_read = get_command(g, &current, &correct_command, &end_of_input);
+        current_line_count++;
+
+        if (!(correct_command && !command_read)) { // jeżeli prawda to komentarz/wiersz pusty
+            if (!correct_command || (current.type != 'B' && current.type != 'I')) {
+                write_line_record(file, STREAM_ERROR, current_line_count, &header.record_count);
+            } else {
+                for (int i = 0; i < MAX_ARGUMENTS; i++) {
+                    if (current.arguments[i] == 0 || current.arguments[i] > INT32_MAX)
+                        correct_command = false;
+                }
+                if (correct_command) {
+                    // grę trzeba utworzyć, bo jej powodzenie decyduje o dalszej interpretacji wejścia
+                    g = gamma_new(current.arguments[0], current.arguments[1],
+                                  current.arguments[2], current.arguments[3]);
+                    if (g != NULL && current.type == 'I') {
+                        interactive = true;
+                    } else if (g != NULL) {
+                        header.width = current.arguments[0];
+                        header.height = current.arguments[1];
+                        header.players = current.arguments[2];
+                        header.areas = current.arguments[3];
+                        write_line_record(file, STREAM_GAME, current_line_count, &header.record_count);
+                    }
+                } else {
+                    write_line_record(file, STREAM_ERROR, current_line_count, &header.record_count);
+                }
+            }
+        }
+    }
+
+    // pozostałe wiersze, tak jak w batch_read_input
+    while (!end_of_input && !interactive) {
+        bool correct_command = true;
+
+        bool command_read = get_command(g, &current, &correct_command, &end_of_input);
+        current_line_count++;
+
+        if (!(correct_command && !command_read)) { // komentarz lub pusta
+            if (!correct_command) {
+                write_line_record(file, STREAM_ERROR, current_line_count, &header.record_count);
+            } else {
+                write_record(file, current.type, current.arguments, &header.record_count);
+            }
+        }
+    }
+    gamma_delete(g);
+
+    bool written = !interactive && fseek(file, 0, SEEK_SET) == 0 &&
+                   fwrite(&header, sizeof(header), 1, file) == 1 && !ferror(file);
+    if (fclose(file) != 0) {
+        written = false;
+    }
+    if (!written) {
+        remove(path);
+    }
+    return written;
+}
+
+/** @brief Sprawdza, czy odwzorowany plik jest poprawnym plikiem z poleceniami.
+ * @param[in] *header – początek pliku,
+ * @param[in] size    – rozmiar pliku w bajtach, co najmniej rozmiar nagłówka.
+ * @return Wartość @p true, jeśli plik jest poprawny, a @p false wpp.
+ */
+static bool valid_stream(const command_stream_header *header, uint64_t size) {
+    uint64_t records = size - sizeof(*header);
+    return memcmp(header->magic, COMMAND_STREAM_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == COMMAND_STREAM_VERSION && header->record_size == sizeof(command_record) &&
+           records % sizeof(command_record) == 0 && records / sizeof(command_record) == header->record_count;
+}
+
+/** @brief Sprawdza, czy kod rekordu jest poleceniem trybu wsadowego wykonywanym na grze.
+ * @param[in] opcode – kod rekordu.
+ * @return Wartość @p true dla kodów m, g, b, f, q i p, a @p false wpp.
+ */
+static bool game_command(uint32_t opcode) {
+    return opcode == 'm' || opcode == 'g' || opcode == 'b' ||
+           opcode == 'f' || opcode == 'q' || opcode == 'p';
+}
+
+bool command_stream_replay(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (uint64_t)status.st_size < sizeof(command_stream_header)) {
+        close(fd);
+        return false;
+    }
+    uint64_t size = status.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const command_stream_header *header = data;
+    if (!valid_stream(header, size)) {
+        munmap(data, size);
+        return false;
+    }
+
+    const command_record *record = (const command_record *)(header + 1);
+    const command_record *end = record + header->record_count;
+    gamma_t *g = NULL;
+    bool replayed = true;
+    command current;
+    for (; record < end && replayed; record++) {
+        if (record->opcode == STREAM_ERROR) {
+            output_error(record_line(record));
+        } else if (record->opcode == STREAM_GAME && g == NULL) {
+            g = gamma_new(header->width, header->height, header->players, header->areas);
+            if (g == NULL) { // przy tworzeniu pliku gra powstała, teraz zabrakło pamięci
+                replayed = false;
+            } else {
+                output_bytes("OK ", sizeof("OK ") - 1);
+                output_number(record_line(record));
+                output_char('\n');
+            }
+        } else if (g != NULL && game_command(record->opcode)) {
+            current.type = record->opcode;
+            memcpy(current.arguments, record->arguments, sizeof(record->arguments));
+            execute_command(g, &current);
+        } else { // plik nie powstał z poprawnego wejścia
+            replayed = false;
+        }
+    }
+    output_flush();
+    gamma_delete(g);
+    munmap(data, size);
+    return replayed;
+}
@@ -0,0 +1,72 @@
+/** @file
+ * Interfejs klasy obsługującej binarny zapis poleceń trybu wsadowego.
+ * Plik zaczyna się nagłówkiem z parametrami polecenia B, po którym następują
+ * rekordy stałej długości: kod polecenia i trzy argumenty. Polecenia są
+ * sprawdzone i przetworzone już przy tworzeniu pliku, więc odtwarzanie
+ * przekazuje je prosto do silnika. Liczby są zapisane w porządku bajtów maszyny.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_COMMAND_STREAM_H
+#define GAMMA_COMMAND_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Wersja formatu pliku
+ */
+#define COMMAND_STREAM_VERSION 1
+
+/**
+ * Kod rekordu oznaczającego udane polecenie B
+ */
+#define STREAM_GAME 'B'
+
+/**
+ * Kod rekordu oznaczającego błędny wiersz wejścia
+ */
+#define STREAM_ERROR 'E'
+
+/** @brief Nagłówek pliku z poleceniami.
+ */
+typedef struct {
+    char magic[8];         ///< napis "GAMMACMD" bez znaku końca
+    uint32_t version;      ///< wersja formatu, @ref COMMAND_STREAM_VERSION
+    uint32_t record_size;  ///< rozmiar jednego rekordu w bajtach
+    uint32_t width;        ///< szerokość planszy z polecenia B
+    uint32_t height;       ///< wysokość planszy z polecenia B
+    uint32_t players;      ///< liczba graczy z polecenia B
+    uint32_t areas;        ///< maksymalna liczba obszarów z polecenia B
+    uint64_t record_count; ///< liczba rekordów w pliku
+} command_stream_header;
+
+/** @brief Jeden rekord pliku z poleceniami.
+ * Kodem jest litera polecenia trybu wsadowego albo @ref STREAM_GAME
+ * lub @ref STREAM_ERROR, których argumentami są młodsza i starsza
+ * połowa numeru wiersza.
+ */
+typedef struct {
+    uint32_t opcode;       ///< kod rekordu
+    uint32_t arguments[3]; ///< argumenty polecenia
+} command_record;
+
+/** @brief Zamienia polecenia tekstowe ze standardowego wejścia na plik binarny.
+ * @param[in] *path – ścieżka do tworzonego pliku.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy nie dało się zapisać pliku
+ * lub wejście wybiera tryb interaktywny.
+ */
+bool command_stream_compile(const char *path);
+
+/** @brief Odtwarza rozgrywkę z pliku binarnego.
+ * Wypisuje dokładnie to samo, co tryb wsadowy dla wejścia, z którego powstał plik.
+ * @param[in] *path – ścieżka do pliku z poleceniami.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy pliku nie dało się
+ * odczytać lub jest niepoprawny.
+ */
+bool command_stream_replay(const char *path);
+
+#endif /* GAMMA_COMMAND_STREAM_H */
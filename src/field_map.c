@@ -0,0 +1,157 @@
+/** @file
+ * Implementacja tablicy haszującej przypisującej polom planszy liczby.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "field_map.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Minimalny rozmiar tablicy wpisów
+ */
+#define MIN_CAPACITY 16
+
+/** @brief Miesza bity klucza.
+ * Kolejne pola planszy mają kolejne indeksy, więc bez mieszania
+ * trafiałyby w sąsiednie wpisy.
+ */
+static inline uint64_t hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    return key;
+}
+
+/** @brief Znajduje wpis z kluczem @p key albo wolny wpis, w którym powinien się znaleźć.
+ */
+static field_map_entry *find_entry(const field_map *map, uint64_t key) {
+    uint64_t mask = map->capacity - 1;
+    uint64_t i = hash(key) & mask;
+    while (map->entries[i].epoch == map->epoch && map->entries[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return &map->entries[i];
+}
+
+void field_map_init(field_map *map) {
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+    map->epoch = 1;
+}
+
+void field_map_destroy(field_map *map) {
+    free(map->entries);
+    field_map_init(map);
+}
+
+bool field_map_reserve(field_map *map, uint64_t count) {
+    // zajętych jest najwyżej pół tablicy, żeby sekwencje próbkowania były krótkie
+    if (2 * (map->count + count) <= map->capacity) {
+        return true;
+    }
+    uint64_t capacity = map->capacity < MIN_CAPACITY ? MIN_CAPACITY : map->capacity;
+    while (2 * (map->count + count) > capacity) {
+        capacity *= 2;
+    }
+    field_map_entry *entries = calloc(capacity, sizeof(field_map_entry));
+    if (entries == NULL) {
+        return false;
+    }
+
+    field_map old = *map;
+    map->entries = entries;
+    map->capacity = capacity;
+    map->count = 0;
+    map->epoch = 1;
+    for (uint64_t i = 0; i < old.capacity; i++) {
+        if (old.entries[i].epoch == old.epoch) {
+            field_map_set(map, old.entries[i].key, old.entries[i].value);
+        }
+    }
+    free(old.entries);
+    return true;
+}
+
+bool field_map_copy(field_map *copy, const field_map *map) {
+    field_map_init(copy);
+    if (map->capacity == 0) {
+        return true;
+    }
+    copy->entries = malloc(map->capacity * sizeof(field_map_entry));
+    if (copy->entries == NULL) {
+        return false;
+    }
+    memcpy(copy->entries, map->entries, map->capacity * sizeof(field_map_entry));
+    copy->capacity = map->capacity;
+    copy->count = map->count;
+    copy->epoch = map->epoch;
+    return true;
+}
+
+void field_map_set(field_map *map, uint64_t key, uint32_t value) {
+    field_map_entry *entry = find_entry(map, key);
+    if (entry->epoch != map->epoch) {
+        entry->key = key;
+        entry->epoch = map->epoch;
+        map->count++;
+    }
+    entry->value = value;
+}
+
+bool field_map_get(const field_map *map, uint64_t key, uint32_t *value) {
+    if (map->count == 0) {
+        return false;
+    }
+    field_map_entry *entry = find_entry(map, key);
+    if (entry->epoch != map->epoch) {
+        return false;
+    }
+    if (value != NULL) {
+        *value = entry->value;
+    }
+    return true;
+}
+
+void field_map_remove(field_map *map, uint64_t key) {
+    if (map->count == 0) {
+        return;
+    }
+    field_map_entry *entry = find_entry(map, key);
+    if (entry->epoch != map->epoch) {
+        return;
+    }
+    // przesuwamy do tyłu wpisy, których sekwencja próbkowania przechodziła przez usuwany
+    uint64_t mask = map->capacity - 1;
+    uint64_t i = entry - map->entries;
+    uint64_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (map->entries[j].epoch != map->epoch) {
+            break;
+        }
+        uint64_t home = hash(map->entries[j].key) & mask;
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            map->entries[i] = map->entries[j];
+            i = j;
+        }
+    }
+    map->entries[i].epoch = 0;
+    map->count--;
+}
+
+void field_map_clear(field_map *map) {
+    map->count = 0;
+    map->epoch++;
+    if (map->epoch == 0) { // po przekręceniu licznika stare wpisy mogłyby ożyć
+        if (map->entries != NULL) {
+            memset(map->entries, 0, map->capacity * sizeof(field_map_entry));
+        }
+        map->epoch = 1;
+    }
+}
@@ -0,0 +1,88 @@
+/** @file
+ * Interfejs tablicy haszującej przypisującej polom planszy liczby.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_FIELD_MAP_H
+#define GAMMA_FIELD_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Jeden wpis tablicy haszującej.
+ * Wpis jest zajęty wtedy i tylko wtedy, gdy jego epoka jest równa epoce tablicy.
+ */
+typedef struct {
+    uint64_t key;   ///< indeks pola
+    uint32_t value; ///< przypisana wartość
+    uint32_t epoch; ///< epoka, w której wpis został zapisany
+} field_map_entry;
+
+/** @brief Tablica haszująca z adresowaniem otwartym.
+ * Czyszczenie całej tablicy polega na zmianie epoki, więc kosztuje O(1).
+ */
+typedef struct {
+    field_map_entry *entries; ///< tablica wpisów, jej rozmiar jest potęgą dwójki
+    uint64_t capacity;        ///< rozmiar tablicy @p entries
+    uint64_t count;           ///< liczba zajętych wpisów
+    uint32_t epoch;           ///< aktualna epoka, liczba dodatnia
+} field_map;
+
+/** @brief Inicjuje pustą tablicę.
+ * @param[out] map – wskaźnik na inicjowaną tablicę.
+ */
+void field_map_init(field_map *map);
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę.
+ * @param[in,out] map – wskaźnik na tablicę.
+ */
+void field_map_destroy(field_map *map);
+
+/** @brief Zapewnia miejsce na nowe wpisy.
+ * Po udanym wywołaniu można wstawić @p count nowych kluczy bez alokowania pamięci.
+ * @param[in,out] map – wskaźnik na tablicę,
+ * @param[in] count   – liczba nowych kluczy.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+bool field_map_reserve(field_map *map, uint64_t count);
+
+/** @brief Tworzy kopię tablicy.
+ * @param[out] copy – wskaźnik na inicjowaną kopię,
+ * @param[in] map   – wskaźnik na kopiowaną tablicę.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci
+ * (wtedy @p copy jest pustą tablicą).
+ */
+bool field_map_copy(field_map *copy, const field_map *map);
+
+/** @brief Przypisuje wartość polu.
+ * Miejsce na nowy klucz musi być wcześniej zapewnione przez @ref field_map_reserve.
+ * @param[in,out] map – wskaźnik na tablicę,
+ * @param[in] key     – indeks pola,
+ * @param[in] value   – przypisywana wartość.
+ */
+void field_map_set(field_map *map, uint64_t key, uint32_t value);
+
+/** @brief Odczytuje wartość przypisaną polu.
+ * @param[in] map    – wskaźnik na tablicę,
+ * @param[in] key    – indeks pola,
+ * @param[out] value – wskaźnik na miejsce na wartość, może być NULL.
+ * @return Wartość @p true, jeśli pole ma przypisaną wartość, a @p false wpp.
+ */
+bool field_map_get(const field_map *map, uint64_t key, uint32_t *value);
+
+/** @brief Usuwa wartość przypisaną polu.
+ * Nic nie robi, jeśli pole nie ma przypisanej wartości.
+ * @param[in,out] map – wskaźnik na tablicę,
+ * @param[in] key     – indeks pola.
+ */
+void field_map_remove(field_map *map, uint64_t key);
+
+/** @brief Usuwa wszystkie wpisy z tablicy.
+ * @param[in,out] map – wskaźnik na tablicę.
+ */
+void field_map_clear(field_map *map);
+
+#endif /* GAMMA_FIELD_MAP_H */
@@ -0,0 +1,148 @@
+/** @file
+ * Implementacja tablicy zbiorów pól przypisanych graczom.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "frontier_table.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Minimalny rozmiar tablicy zbiorów i tablicy pól zbioru
+ */
+#define MIN_CAPACITY 4
+
+/** @brief Podaje klucz pola zbioru w tablicy pozycji.
+ */
+static inline uint64_t position_key(uint32_t set, uint32_t field) {
+    return (uint64_t)set << 32 | field;
+}
+
+/** @brief Podaje numer zbioru gracza.
+ * @return Wartość @p true, jeśli gracz ma zbiór, a @p false wpp.
+ */
+static inline bool set_number(const frontier_table *table, uint32_t player, uint32_t *set) {
+    return field_map_get(&table->set_of, player, set);
+}
+
+void frontier_table_init(frontier_table *table) {
+    table->sets = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    field_map_init(&table->set_of);
+    field_map_init(&table->position);
+}
+
+void frontier_table_destroy(frontier_table *table) {
+    for (uint32_t i = 0; i < table->count; i++) {
+        free(table->sets[i].fields);
+    }
+    free(table->sets);
+    field_map_destroy(&table->set_of);
+    field_map_destroy(&table->position);
+    frontier_table_init(table);
+}
+
+bool frontier_table_copy(frontier_table *copy, const frontier_table *table) {
+    frontier_table_init(copy);
+    if (table->count > 0) {
+        copy->sets = malloc(table->capacity * sizeof(frontier));
+        if (copy->sets == NULL) {
+            return false;
+        }
+        copy->capacity = table->capacity;
+    }
+    for (uint32_t i = 0; i < table->count; i++) {
+        const frontier *set = &table->sets[i];
+        frontier *set_copy = &copy->sets[i];
+        set_copy->fields = malloc(set->capacity * sizeof(uint32_t));
+        if (set_copy->fields == NULL) {
+            return false;
+        }
+        memcpy(set_copy->fields, set->fields, set->count * sizeof(uint32_t));
+        set_copy->count = set->count;
+        set_copy->capacity = set->capacity;
+        copy->count++;
+    }
+    return field_map_copy(&copy->set_of, &table->set_of) && field_map_copy(&copy->position, &table->position);
+}
+
+bool frontier_table_reserve(frontier_table *table, uint32_t player, uint32_t count) {
+    uint32_t set;
+    if (!set_number(table, player, &set)) {
+        if (table->count == table->capacity) {
+            uint32_t capacity = table->capacity < MIN_CAPACITY ? MIN_CAPACITY : 2 * table->capacity;
+            frontier *sets = realloc(table->sets, capacity * sizeof(frontier));
+            if (sets == NULL) {
+                return false;
+            }
+            table->sets = sets;
+            table->capacity = capacity;
+        }
+        if (!field_map_reserve(&table->set_of, 1)) {
+            return false;
+        }
+        set = table->count++;
+        table->sets[set].fields = NULL;
+        table->sets[set].count = 0;
+        table->sets[set].capacity = 0;
+        field_map_set(&table->set_of, player, set);
+    }
+
+    frontier *s = &table->sets[set];
+    if ((uint64_t)s->count + count > s->capacity) {
+        uint64_t capacity = s->capacity < MIN_CAPACITY ? MIN_CAPACITY : 2 * (uint64_t)s->capacity;
+        while (capacity < (uint64_t)s->count + count) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) {
+            capacity = UINT32_MAX;
+        }
+        uint32_t *fields = realloc(s->fields, capacity * sizeof(uint32_t));
+        if (fields == NULL) {
+            return false;
+        }
+        s->fields = fields;
+        s->capacity = capacity;
+    }
+    return field_map_reserve(&table->position, count);
+}
+
+void frontier_table_insert(frontier_table *table, uint32_t player, uint32_t field) {
+    uint32_t set = 0;
+    bool exists = set_number(table, player, &set);
+    assert(exists);
+    (void)exists;
+    frontier *s = &table->sets[set];
+    assert(s->count < s->capacity && !field_map_get(&table->position, position_key(set, field), NULL));
+    field_map_set(&table->position, position_key(set, field), s->count);
+    s->fields[s->count++] = field;
+}
+
+void frontier_table_remove(frontier_table *table, uint32_t player, uint32_t field) {
+    uint32_t set = 0, position = 0;
+    bool exists = set_number(table, player, &set) &&
+                  field_map_get(&table->position, position_key(set, field), &position);
+    assert(exists);
+    (void)exists;
+    // ostatnie pole zbioru zajmuje miejsce usuwanego
+    frontier *s = &table->sets[set];
+    uint32_t last = s->fields[--s->count];
+    s->fields[position] = last;
+    field_map_set(&table->position, position_key(set, last), position);
+    field_map_remove(&table->position, position_key(set, field));
+}
+
+bool frontier_table_contains(const frontier_table *table, uint32_t player, uint32_t field) {
+    uint32_t set;
+    return set_number(table, player, &set) && field_map_get(&table->position, position_key(set, field), NULL);
+}
+
+const frontier *frontier_table_get(const frontier_table *table, uint32_t player) {
+    uint32_t set;
+    return set_number(table, player, &set) ? &table->sets[set] : NULL;
+}
@@ -0,0 +1,97 @@
+/** @file
+ * Interfejs tablicy zbiorów pól przypisanych graczom.
+ * Silnik trzyma w takich zbiorach pola sąsiadujące z polami gracza, dzięki
+ * czemu wypisanie ich kosztuje tyle, ile jest pól, a nie tyle, ile ma plansza.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_FRONTIER_TABLE_H
+#define GAMMA_FRONTIER_TABLE_H
+
+#include "field_map.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Zbiór pól jednego gracza.
+ */
+typedef struct {
+    uint32_t *fields;  ///< indeksy pól zbioru w dowolnej kolejności
+    uint32_t count;    ///< liczba pól zbioru
+    uint32_t capacity; ///< rozmiar tablicy @p fields
+} frontier;
+
+/** @brief Zbiory pól graczy.
+ * Zbiór gracza powstaje przy pierwszym zapewnieniu w nim miejsca i nigdy
+ * się nie zmniejsza, więc wstawienie pola, które już kiedyś było w zbiorze
+ * przy tej samej liczbie pól, nie wymaga pamięci.
+ */
+typedef struct {
+    frontier *sets;        ///< zbiory graczy
+    uint32_t count;        ///< liczba utworzonych zbiorów
+    uint32_t capacity;     ///< rozmiar tablicy @p sets
+    field_map set_of;      ///< numer zbioru gracza o danym numerze
+    field_map position;    ///< pozycja pola w zbiorze, kluczem jest numer zbioru i indeks pola
+} frontier_table;
+
+/** @brief Inicjuje tablicę bez zbiorów.
+ * @param[out] table – wskaźnik na inicjowaną tablicę.
+ */
+void frontier_table_init(frontier_table *table);
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę.
+ * @param[in,out] table – wskaźnik na tablicę.
+ */
+void frontier_table_destroy(frontier_table *table);
+
+/** @brief Tworzy kopię tablicy.
+ * @param[out] copy  – wskaźnik na inicjowaną kopię,
+ * @param[in] table  – wskaźnik na kopiowaną tablicę.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci
+ * (wtedy kopię trzeba zwolnić przez @ref frontier_table_destroy).
+ */
+bool frontier_table_copy(frontier_table *copy, const frontier_table *table);
+
+/** @brief Zapewnia miejsce na nowe pola w zbiorze gracza, tworząc go w razie potrzeby.
+ * @param[in,out] table – wskaźnik na tablicę,
+ * @param[in] player    – numer gracza,
+ * @param[in] count     – liczba nowych pól.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+bool frontier_table_reserve(frontier_table *table, uint32_t player, uint32_t count);
+
+/** @brief Dodaje pole do zbioru gracza.
+ * Pola nie może być w zbiorze, a miejsce musi być wcześniej zapewnione
+ * przez @ref frontier_table_reserve.
+ * @param[in,out] table – wskaźnik na tablicę,
+ * @param[in] player    – numer gracza,
+ * @param[in] field     – indeks pola.
+ */
+void frontier_table_insert(frontier_table *table, uint32_t player, uint32_t field);
+
+/** @brief Usuwa pole ze zbioru gracza.
+ * Pole musi być w zbiorze.
+ * @param[in,out] table – wskaźnik na tablicę,
+ * @param[in] player    – numer gracza,
+ * @param[in] field     – indeks pola.
+ */
+void frontier_table_remove(frontier_table *table, uint32_t player, uint32_t field);
+
+/** @brief Sprawdza, czy pole jest w zbiorze gracza.
+ * @param[in] table  – wskaźnik na tablicę,
+ * @param[in] player – numer gracza,
+ * @param[in] field  – indeks pola.
+ * @return Wartość @p true, jeśli pole jest w zbiorze, a @p false wpp.
+ */
+bool frontier_table_contains(const frontier_table *table, uint32_t player, uint32_t field);
+
+/** @brief Podaje zbiór gracza.
+ * @param[in] table  – wskaźnik na tablicę,
+ * @param[in] player – numer gracza.
+ * @return Wskaźnik na zbiór lub NULL, gdy gracz nie ma jeszcze zbioru.
+ */
+const frontier *frontier_table_get(const frontier_table *table, uint32_t player);
+
+#endif /* GAMMA_FRONTIER_TABLE_H */
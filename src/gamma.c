@@ -7,14 +7,674 @@
  */
 
 #include "gamma.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /**
- * Funckja pomocnicza zamieniająca wskaźniki na pola
+ * Oznakowanie braku pola, np. przy porównywaniu reprezentantów sąsiadów
  */
-static void swap(field **a, field **b) {
-    field *c = *a;
-    *a = *b;
-    *b = c;
+#define NO_FIELD UINT32_MAX
+
+/**
+ * Ograniczenie na numery węzłów drzew obszarów i numery opisów obszarów
+ */
+#define NODE_LIMIT (UINT32_C(1) << 30)
+
+/**
+ * Maska wydobywająca z węzła numer rodzica lub numer opisu obszaru
+ */
+#define NODE_MASK (NODE_LIMIT - 1)
+
+/**
+ * Znacznik reprezentanta obszaru w węźle, pozostałe bity to numer opisu obszaru
+ */
+#define ROOT_FLAG (UINT32_C(1) << 31)
+
+/**
+ * Znacznik węzła pola, które dostało węzeł zapasowy, a jego własny węzeł
+ * pozostał w drzewie dawnego obszaru tylko jako element ścieżek innych pól
+ */
+#define MOVED_FLAG (UINT32_C(1) << 30)
+
+/**
+ * Wynik przeszukiwania, któremu zabrakło pamięci
+ */
+#define SEARCH_FAILED UINT32_MAX
+
+/**
+ * Minimalny rozmiar tablicy opisów obszarów
+ */
+#define MIN_REGIONS 16
+
+/**
+ * Liczba sąsiadów każdego pola planszy
+ */
+#define NEIGHBOURS 4
+
+/**
+ * Liczba pól otaczających pole planszy, razem z narożnymi
+ */
+#define RING 8
+
+/**
+ * Liczba pól kwadratu 3 na 3 o środku w danym polu
+ */
+#define SQUARE 9
+
+/**
+ * Liczba bitów współrzędnej pola wewnątrz kafelka
+ */
+#define TILE_BITS 6
+
+/**
+ * Długość boku kafelka
+ */
+#define TILE_SIDE (UINT32_C(1) << TILE_BITS)
+
+/**
+ * Liczba pól kafelka
+ */
+#define TILE_CELLS (TILE_SIDE * TILE_SIDE)
+
+/**
+ * Numer kafelka złożonego z samych pól @ref BORDER, sąsiada kafelków brzegowych
+ */
+#define BORDER_TILE 0
+
+/**
+ * Oznakowanie brakującego sąsiedniego kafelka
+ */
+#define MISSING_TILE UINT32_MAX
+
+/**
+ * Rodzaj wpisu dziennika: właściciel pola
+ */
+#define JOURNAL_OWNER 0
+
+/**
+ * Rodzaj wpisu dziennika: zawartość węzła drzewa obszarów
+ */
+#define JOURNAL_NODE 1
+
+/**
+ * Rodzaj wpisu dziennika: element tablicy pól ryzykownych
+ */
+#define JOURNAL_RISKY 2
+
+/**
+ * Rodzaj wpisu dziennika: węzeł zapasowy pola w tablicy @p moved
+ */
+#define JOURNAL_MOVED 3
+
+/**
+ * Rodzaj wpisu dziennika: pozycja pola w tablicy @p risky_position
+ */
+#define JOURNAL_RISKY_POSITION 4
+
+/**
+ * Wartość wpisu dziennika dla klucza, którego nie było w tablicy haszującej
+ */
+#define JOURNAL_ABSENT UINT64_MAX
+
+/**
+ * Liczba wpisów dziennika zapewniana przed każdym ruchem, poza wpisami za przeniesione pola
+ */
+#define JOURNAL_MOVE_ENTRIES 512
+
+/**
+ * Liczba wpisów dziennika na każde pole przeniesione do nowego obszaru przy złotym ruchu
+ */
+#define JOURNAL_MOVED_ENTRIES 4
+
+/**
+ * Liczba pól w kwadracie 5 na 5, z którego pochodzą wszyscy gracze zmieniani przez ruch
+ */
+#define JOURNAL_WINDOW 25
+
+/**
+ * Liczba opisów obszarów zapewniana w dzienniku przed każdym ruchem; złoty ruch
+ * zmienia najwyżej 8 opisów obszarów ofiary i 7 opisów obszarów gracza
+ */
+#define JOURNAL_MOVE_REGIONS 16
+
+/** @brief Podaje właściciela pola o danym indeksie.
+ * Największa wartość wpisu oznacza @ref BORDER niezależnie od jego rozmiaru.
+ */
+static inline uint32_t owner_get(gamma_t *g, uint32_t field) {
+    if (g->owner_size == sizeof(uint8_t)) {
+        uint8_t owner = ((uint8_t *)g->owners)[field];
+        return owner == UINT8_MAX ? BORDER : owner;
+    }
+    if (g->owner_size == sizeof(uint16_t)) {
+        uint16_t owner = ((uint16_t *)g->owners)[field];
+        return owner == UINT16_MAX ? BORDER : owner;
+    }
+    return ((uint32_t *)g->owners)[field];
+}
+
+/** @brief Zapisuje właściciela pola o danym indeksie.
+ * Obcięcie @ref BORDER do rozmiaru wpisu daje największą wartość wpisu.
+ */
+static inline void owner_set(gamma_t *g, uint32_t field, uint32_t owner) {
+    if (g->owner_size == sizeof(uint8_t)) {
+        ((uint8_t *)g->owners)[field] = (uint8_t)owner;
+    } else if (g->owner_size == sizeof(uint16_t)) {
+        ((uint16_t *)g->owners)[field] = (uint16_t)owner;
+    } else {
+        ((uint32_t *)g->owners)[field] = owner;
+    }
+}
+
+/** @brief Podaje rozmiar bloku z właścicielami i węzłami pól planszy bez kafelków.
+ * Węzły zaczynają się od pierwszego adresu podzielnego przez ich rozmiar.
+ */
+static inline uint64_t dense_block_size(gamma_t *g) {
+    uint64_t owner_bytes = ((uint64_t)g->cell_count * g->owner_size + sizeof(uint32_t) - 1) /
+                           sizeof(uint32_t) * sizeof(uint32_t);
+    return owner_bytes + (uint64_t)g->cell_count * sizeof(uint32_t);
+}
+
+/** @brief Podaje długość wiersza planszy razem z ramką.
+ */
+static inline uint32_t row_length(gamma_t *g) {
+    return g->width + 2;
+}
+
+/** @brief Podaje indeks pola (@p x, @p y) w tablicach planszy.
+ * Plansza jest otoczona ramką pól o właścicielu @ref BORDER,
+ * więc pole (0, 0) ma indeks o jeden wiersz i jedną kolumnę dalej niż początek tablicy.
+ */
+static inline uint32_t field_index(gamma_t *g, uint32_t x, uint32_t y) {
+    return (y + 1) * row_length(g) + x + 1;
+}
+
+/** @brief Podaje klucz kafelka o danych współrzędnych w tablicy @p tiles.
+ */
+static inline uint64_t tile_key(uint64_t tile_x, uint64_t tile_y) {
+    return tile_y << 32 | tile_x;
+}
+
+/** @brief Podaje indeks pola (@p x, @p y) w tablicach planszy.
+ * @return indeks pola lub NO_FIELD, gdy pole leży w nieutworzonym kafelku
+ * (takie pole jest wolne)
+ */
+static uint32_t board_cell(gamma_t *g, uint32_t x, uint32_t y) {
+    if (!g->tiled) {
+        return field_index(g, x, y);
+    }
+    uint32_t tile;
+    if (!field_map_get(&g->tiles, tile_key(x >> TILE_BITS, y >> TILE_BITS), &tile)) {
+        return NO_FIELD;
+    }
+    return tile * TILE_CELLS + ((y & (TILE_SIDE - 1)) << TILE_BITS) + (x & (TILE_SIDE - 1));
+}
+
+/** @brief Wyznacza współrzędne pola planszy o danym indeksie.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field   – indeks pola planszy,
+ * @param[out] x, y   – współrzędne pola.
+ */
+static inline void field_coordinates(gamma_t *g, uint32_t field, uint32_t *x, uint32_t *y) {
+    if (!g->tiled) {
+        *x = field % row_length(g) - 1;
+        *y = field / row_length(g) - 1;
+        return;
+    }
+    uint64_t key = g->tile_keys[field / TILE_CELLS];
+    *x = (key & UINT32_MAX) * TILE_SIDE + (field & (TILE_SIDE - 1));
+    *y = (key >> 32) * TILE_SIDE + (field >> TILE_BITS & (TILE_SIDE - 1));
+}
+
+/** @brief Podaje właściciela pola (@p x, @p y).
+ */
+static inline uint32_t owner_at(gamma_t *g, uint32_t x, uint32_t y) {
+    uint32_t field = board_cell(g, x, y);
+    return field == NO_FIELD ? NONE : owner_get(g, field);
+}
+
+/** @brief Podaje indeks pola przesuniętego względem danego o (@p dx, @p dy).
+ * Przesunięcia są z zakresu od -1 do 1. Przy planszy z kafelkami pole docelowe
+ * musi leżeć w utworzonym kafelku albo poza planszą.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field   – indeks pola,
+ * @param[in] dx, dy  – przesunięcie w poziomie i w pionie.
+ * @return indeks pola docelowego
+ */
+static inline uint32_t cell_at(gamma_t *g, uint32_t field, int dx, int dy) {
+    if (!g->tiled) {
+        return field + (uint32_t)(dy * (int32_t)row_length(g) + dx);
+    }
+    int x = (int)(field & (TILE_SIDE - 1)) + dx;
+    int y = (int)(field >> TILE_BITS & (TILE_SIDE - 1)) + dy;
+    int tile_dx = x < 0 ? -1 : x >= (int)TILE_SIDE ? 1 : 0;
+    int tile_dy = y < 0 ? -1 : y >= (int)TILE_SIDE ? 1 : 0;
+    if (tile_dx == 0 && tile_dy == 0) {
+        return field + (uint32_t)(dy * (int32_t)TILE_SIDE + dx);
+    }
+    uint32_t tile = g->tile_adjacent[field / TILE_CELLS * SQUARE + (tile_dy + 1) * 3 + tile_dx + 1];
+    assert(tile != MISSING_TILE);
+    return tile * TILE_CELLS + (((uint32_t)y & (TILE_SIDE - 1)) << TILE_BITS) + ((uint32_t)x & (TILE_SIDE - 1));
+}
+
+/** @brief Wyznacza indeksy sąsiadów pola.
+ * Dzięki ramce wszyscy czterej sąsiedzi pola planszy zawsze istnieją,
+ * sąsiad spoza planszy ma właściciela @ref BORDER.
+ * Kolejność: lewy, górny, prawy, dolny.
+ * @param[in] g          – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field      – indeks pola planszy,
+ * @param[out] neighbour – tablica na indeksy sąsiadów.
+ */
+static inline void neighbours(gamma_t *g, uint32_t field, uint32_t neighbour[NEIGHBOURS]) {
+    if (g->tiled) {
+        neighbour[0] = cell_at(g, field, -1, 0);
+        neighbour[1] = cell_at(g, field, 0, 1);
+        neighbour[2] = cell_at(g, field, 1, 0);
+        neighbour[3] = cell_at(g, field, 0, -1);
+        return;
+    }
+    neighbour[0] = field - 1;
+    neighbour[1] = field + row_length(g);
+    neighbour[2] = field + 1;
+    neighbour[3] = field - row_length(g);
+}
+
+/** @brief Zapewnia miejsce na nowy kafelek.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci
+ * lub numerów węzłów.
+ */
+static bool reserve_tile(gamma_t *g) {
+    if ((uint64_t)g->cell_count + TILE_CELLS + g->spare_count > NODE_LIMIT) {
+        return false;
+    }
+    if (g->cell_count + TILE_CELLS > g->cell_capacity) {
+        uint64_t capacity = 2 * (uint64_t)g->cell_capacity;
+        if (capacity < 2 * TILE_CELLS) {
+            capacity = 2 * TILE_CELLS;
+        }
+        if (capacity > NODE_LIMIT) {
+            capacity = NODE_LIMIT;
+        }
+        void *owners = realloc(g->owners, capacity * g->owner_size);
+        if (owners == NULL) {
+            return false;
+        }
+        g->owners = owners;
+        uint32_t *roots = realloc(g->roots, capacity * sizeof(uint32_t));
+        if (roots == NULL) {
+            return false;
+        }
+        g->roots = roots;
+        uint32_t *tile_adjacent = realloc(g->tile_adjacent, capacity / TILE_CELLS * SQUARE * sizeof(uint32_t));
+        if (tile_adjacent == NULL) {
+            return false;
+        }
+        g->tile_adjacent = tile_adjacent;
+        uint64_t *tile_keys = realloc(g->tile_keys, capacity / TILE_CELLS * sizeof(uint64_t));
+        if (tile_keys == NULL) {
+            return false;
+        }
+        g->tile_keys = tile_keys;
+        g->cell_capacity = capacity;
+    }
+    return field_map_reserve(&g->tiles, 1);
+}
+
+/** @brief Tworzy kafelek o danych współrzędnych.
+ * Pola kafelka leżące poza planszą dostają właściciela @ref BORDER, pozostałe są wolne.
+ * Kafelek i jego istniejący sąsiedzi zapamiętują się nawzajem jako sąsiadów.
+ * Miejsce na kafelek musi być wcześniej zapewnione przez @ref reserve_tile.
+ * @param[in,out] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] tile_x, tile_y – współrzędne kafelka.
+ */
+static void tile_new(gamma_t *g, uint32_t tile_x, uint32_t tile_y) {
+    uint32_t tile = g->cell_count / TILE_CELLS;
+    g->cell_count += TILE_CELLS;
+    for (uint32_t y = 0; y < TILE_SIDE; y++) {
+        for (uint32_t x = 0; x < TILE_SIDE; x++) {
+            uint64_t board_x = (uint64_t)tile_x * TILE_SIDE + x;
+            uint64_t board_y = (uint64_t)tile_y * TILE_SIDE + y;
+            uint32_t field = tile * TILE_CELLS + y * TILE_SIDE + x;
+            owner_set(g, field, board_x < g->width && board_y < g->height ? NONE : BORDER);
+            g->roots[field] = 0;
+        }
+    }
+
+    uint64_t columns = ((uint64_t)g->width + TILE_SIDE - 1) / TILE_SIDE;
+    uint64_t rows = ((uint64_t)g->height + TILE_SIDE - 1) / TILE_SIDE;
+    for (uint32_t i = 0; i < SQUARE; i++) {
+        int64_t x = (int64_t)tile_x + (int)(i % 3) - 1;
+        int64_t y = (int64_t)tile_y + (int)(i / 3) - 1;
+        uint32_t adjacent = BORDER_TILE;
+        if (i == SQUARE / 2) {
+            adjacent = tile;
+        } else if (x >= 0 && y >= 0 && (uint64_t)x < columns && (uint64_t)y < rows) {
+            if (field_map_get(&g->tiles, tile_key(x, y), &adjacent)) {
+                g->tile_adjacent[adjacent * SQUARE + SQUARE - 1 - i] = tile;
+            } else {
+                adjacent = MISSING_TILE;
+            }
+        }
+        g->tile_adjacent[tile * SQUARE + i] = adjacent;
+    }
+    field_map_set(&g->tiles, tile_key(tile_x, tile_y), tile);
+    g->tile_keys[tile] = tile_key(tile_x, tile_y);
+}
+
+/** @brief Tworzy kafelki, z których ruch na pole (@p x, @p y) może odczytać pola.
+ * Zmiana właściciela pola sięga do pól odległych o dwa w każdym kierunku,
+ * więc tworzone są wszystkie kafelki przecinające kwadrat 5 na 5 wokół pola.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool materialize_tiles(gamma_t *g, uint32_t x, uint32_t y) {
+    if (!g->tiled) {
+        return true;
+    }
+    uint64_t x_end = (uint64_t)x + 2 < g->width ? (uint64_t)x + 2 : g->width - 1;
+    uint64_t y_end = (uint64_t)y + 2 < g->height ? (uint64_t)y + 2 : g->height - 1;
+    for (uint64_t tile_y = (y < 2 ? 0 : y - 2) / TILE_SIDE; tile_y <= y_end / TILE_SIDE; tile_y++) {
+        for (uint64_t tile_x = (x < 2 ? 0 : x - 2) / TILE_SIDE; tile_x <= x_end / TILE_SIDE; tile_x++) {
+            if (!field_map_get(&g->tiles, tile_key(tile_x, tile_y), NULL)) {
+                if (!reserve_tile(g)) {
+                    return false;
+                }
+                tile_new(g, tile_x, tile_y);
+            }
+        }
+    }
+    return true;
+}
+
+/** @brief Podaje istniejący opis gracza do zapisu.
+ * Gracz musi mieć już utworzony opis, np. dlatego, że jest właścicielem
+ * jakiegoś pola albo wykonuje właśnie ruch.
+ */
+static inline player *player_at(gamma_t *g, uint32_t number) {
+    return player_table_at(&g->players, number);
+}
+
+/** @brief Podaje opis gracza do odczytu, także gracza bez utworzonego opisu.
+ */
+static inline const player *player_info(gamma_t *g, uint32_t number) {
+    return player_table_get(&g->players, number);
+}
+
+/** @brief Miesza bity liczby, tak aby bliskie argumenty dawały niezależne wyniki.
+ * Zamiast tablicy losowych kluczy, która dla dużych plansz i wielu graczy
+ * nie zmieściłaby się w pamięci, klucze skrótu są wyliczane tą funkcją.
+ */
+static inline uint64_t hash_mix(uint64_t z) {
+    z += UINT64_C(0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+/** @brief Uwzględnia w skrócie stanu gry zmianę właściciela pola (@p x, @p y).
+ * Wolne pole nie ma klucza, więc wystarczy wywołać funkcję raz dla usuwanego
+ * i raz dla nowego właściciela.
+ */
+static inline void hash_field(gamma_t *g, uint32_t x, uint32_t y, uint32_t owner) {
+    g->hash ^= hash_mix(hash_mix((uint64_t)y << 32 | x) + owner);
+}
+
+/** @brief Oznacza złoty ruch gracza jako wykonany, poprawiając skrót stanu gry.
+ * Gracz musi mieć utworzony opis.
+ */
+static inline void use_golden_move(gamma_t *g, uint32_t player) {
+    player_at(g, player)->golden_unused = false;
+    g->hash ^= hash_mix(~(uint64_t)player);
+}
+
+/** @brief Przenosi zmianę właściciela pola na planszę bitową, jeśli gra ją ma.
+ * Wywoływana przed zapisaniem nowego właściciela w @p g->owners.
+ */
+static inline void bits_set_owner(gamma_t *g, uint32_t field, uint32_t owner) {
+    if (g->bits != NULL) {
+        uint32_t x, y;
+        field_coordinates(g, field, &x, &y);
+        bitboard_set_owner(g->bits, x, y, owner_get(g, field), owner);
+    }
+}
+
+/** @brief Sprawdza poprawność wskaźnika na stan gry i numeru gracza.
+ */
+static inline bool valid_player(gamma_t *g, uint32_t player) {
+    return g != NULL && player >= 1 && player <= g->player_count;
+}
+
+/** @brief Powiększa tablicę elementów dziennika.
+ * @param[in,out] array    – wskaźnik na tablicę,
+ * @param[in,out] capacity – rozmiar tablicy,
+ * @param[in] needed       – potrzebny rozmiar,
+ * @param[in] size         – rozmiar elementu w bajtach.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool journal_grow(void **array, uint64_t *capacity, uint64_t needed, size_t size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    uint64_t new_capacity = 2 * *capacity > needed ? 2 * *capacity : needed;
+    void *grown = realloc(*array, new_capacity * size);
+    if (grown == NULL) {
+        return false;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+/** @brief Usuwa wszystkie ruchy z dziennika.
+ */
+static void journal_clear(move_journal *journal) {
+    free(journal->entries);
+    free(journal->players);
+    free(journal->regions);
+    free(journal->moves);
+    journal->entries = NULL;
+    journal->entry_count = 0;
+    journal->entry_capacity = 0;
+    journal->players = NULL;
+    journal->player_count = 0;
+    journal->player_capacity = 0;
+    journal->regions = NULL;
+    journal->region_count = 0;
+    journal->region_capacity = 0;
+    journal->moves = NULL;
+    journal->move_count = 0;
+    journal->move_capacity = 0;
+}
+
+/** @brief Zapisuje w dzienniku poprzednią wartość.
+ * Zmiany dokonane między ruchami, np. skracanie ścieżek, należą do ostatniego ruchu,
+ * bo tylko z nim da się je cofnąć. Jeśli zapewnione miejsce się skończy i zabraknie pamięci na więcej, ruchu nie da się
+ * już cofnąć, więc dziennik jest wyłączany.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] kind    – rodzaj zmienianej wartości,
+ * @param[in] index   – indeks zmienianej wartości,
+ * @param[in] value   – wartość przed zmianą.
+ */
+static inline void journal_record(gamma_t *g, uint32_t kind, uint32_t index, uint64_t value) {
+    move_journal *journal = &g->journal;
+    if (!journal->enabled || journal->move_count == 0) {
+        return;
+    }
+    if (!journal_grow((void **)&journal->entries, &journal->entry_capacity, journal->entry_count + 1,
+                      sizeof(journal_entry))) {
+        journal->enabled = false;
+        journal_clear(journal);
+        return;
+    }
+    journal_entry *entry = &journal->entries[journal->entry_count++];
+    entry->kind = kind;
+    entry->index = index;
+    entry->value = value;
+}
+
+/** @brief Zapisuje w dzienniku wartość przypisaną kluczowi w tablicy haszującej.
+ */
+static inline void journal_record_map(gamma_t *g, uint32_t kind, const field_map *map, uint32_t key) {
+    if (g->journal.enabled) {
+        uint32_t value;
+        journal_record(g, kind, key, field_map_get(map, key, &value) ? value : JOURNAL_ABSENT);
+    }
+}
+
+/** @brief Zapamiętuje w dzienniku opis obszaru przed jego zmianą.
+ * Opis obszaru nie mieści się w jednym wpisie, więc trafia do osobnej tablicy,
+ * na takich samych zasadach jak w @ref journal_record.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] id      – numer zmienianego opisu.
+ */
+static void journal_save_region(gamma_t *g, uint32_t id) {
+    move_journal *journal = &g->journal;
+    if (!journal->enabled || journal->move_count == 0) {
+        return;
+    }
+    if (!journal_grow((void **)&journal->regions, &journal->region_capacity, journal->region_count + 1,
+                      sizeof(journal_region))) {
+        journal->enabled = false;
+        journal_clear(journal);
+        return;
+    }
+    journal_region *saved = &journal->regions[journal->region_count++];
+    saved->id = id;
+    saved->record = g->regions[id];
+}
+
+/** @brief Zapewnia miejsce w dzienniku na ruch.
+ * Ruch, który przenosi pola do nowych obszarów, potrzebuje dodatkowych wpisów.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] moved   – liczba pól przenoszonych do nowych obszarów.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool reserve_journal(gamma_t *g, uint64_t moved) {
+    move_journal *journal = &g->journal;
+    if (!journal->enabled) {
+        return true;
+    }
+    return journal_grow((void **)&journal->entries, &journal->entry_capacity,
+                        journal->entry_count + JOURNAL_MOVE_ENTRIES + JOURNAL_MOVED_ENTRIES * moved,
+                        sizeof(journal_entry)) &&
+           journal_grow((void **)&journal->players, &journal->player_capacity,
+                        journal->player_count + JOURNAL_WINDOW + 1, sizeof(journal_player)) &&
+           journal_grow((void **)&journal->regions, &journal->region_capacity,
+                        journal->region_count + JOURNAL_MOVE_REGIONS, sizeof(journal_region)) &&
+           journal_grow((void **)&journal->moves, &journal->move_capacity, journal->move_count + 1,
+                        sizeof(journal_move));
+}
+
+/** @brief Zapamiętuje opis gracza sprzed ruchu.
+ */
+static void journal_save_player(gamma_t *g, uint32_t number) {
+    journal_player *saved = &g->journal.players[g->journal.player_count++];
+    saved->number = number;
+    saved->record = *player_info(g, number);
+}
+
+/** @brief Rozpoczyna w dzienniku ruch na pole (@p x, @p y).
+ * Ruch zmienia opisy tylko tego gracza i właścicieli pól kwadratu 5 na 5 wokół pola,
+ * więc tylko te opisy są zapamiętywane. Miejsce musi być wcześniej zapewnione
+ * przez @ref reserve_journal.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza wykonującego ruch, z utworzonym opisem,
+ * @param[in] x, y    – współrzędne pola,
+ * @param[in] field   – indeks pola.
+ */
+static void journal_begin(gamma_t *g, uint32_t player, uint32_t x, uint32_t y, uint32_t field) {
+    move_journal *journal = &g->journal;
+    if (!journal->enabled) {
+        return;
+    }
+    journal_move *move = &journal->moves[journal->move_count++];
+    move->entry_start = journal->entry_count;
+    move->player_start = journal->player_count;
+    move->region_start = journal->region_count;
+    move->busy_count = g->busy_count;
+    move->hash = g->hash;
+    move->field = field;
+    move->spare_count = g->spare_count;
+    move->region_count = g->region_count;
+    move->free_region = g->free_region;
+    move->risky_count = g->risky_count;
+
+    journal_save_player(g, player);
+    for (int64_t dy = -2; dy <= 2; dy++) {
+        for (int64_t dx = -2; dx <= 2; dx++) {
+            if ((int64_t)x + dx < 0 || (int64_t)y + dy < 0 ||
+                (int64_t)x + dx >= g->width || (int64_t)y + dy >= g->height) {
+                continue;
+            }
+            uint32_t owner = owner_at(g, x + dx, y + dy);
+            if (owner != NONE && owner != player) {
+                journal_save_player(g, owner);
+            }
+        }
+    }
+}
+
+void gamma_journal_enable(gamma_t *g, bool enabled) {
+    if (g == NULL) {
+        return;
+    }
+    if (!enabled) {
+        journal_clear(&g->journal);
+    }
+    g->journal.enabled = enabled;
+}
+
+/** @brief Tworzy całą planszę razem z ramką w jednym bloku pamięci.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fields  – liczba pól planszy razem z ramką, mniejsza od @ref NODE_LIMIT.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool dense_board_init(gamma_t *g, uint64_t fields) {
+    // właściciele i rodzice wszystkich pól leżą w jednym ciągłym bloku
+    g->cell_count = fields;
+    g->owners = malloc(dense_block_size(g));
+    if (g->owners == NULL) {
+        return false;
+    }
+    g->roots = (uint32_t *)((char *)g->owners + dense_block_size(g)) - fields;
+
+    for (uint32_t i = 0; i < fields; i++) {
+        owner_set(g, i, BORDER);
+        g->roots[i] = 0;
+    }
+    for (uint32_t y = 0; y < g->height; y++) {
+        for (uint32_t x = 0; x < g->width; x++) {
+            owner_set(g, field_index(g, x, y), NONE);
+        }
+    }
+    return true;
+}
+
+/** @brief Tworzy planszę z kafelkami, na razie z samym kafelkiem ramki.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool tiled_board_init(gamma_t *g) {
+    g->owners = NULL;
+    g->roots = NULL;
+    g->cell_count = 0;
+    g->cell_capacity = 0;
+    if (!reserve_tile(g)) {
+        return false;
+    }
+    // kafelek ramki nie leży na planszy i jest sąsiadem samego siebie
+    g->cell_count = TILE_CELLS;
+    for (uint32_t i = 0; i < TILE_CELLS; i++) {
+        owner_set(g, i, BORDER);
+        g->roots[i] = 0;
+    }
+    for (uint32_t i = 0; i < SQUARE; i++) {
+        g->tile_adjacent[i] = BORDER_TILE;
+    }
+    g->tile_keys[BORDER_TILE] = tile_key(UINT32_MAX, UINT32_MAX);
+    return true;
 }
 
 gamma_t *gamma_new(uint32_t width, uint32_t height,
@@ -22,6 +682,11 @@ gamma_t *gamma_new(uint32_t width, uint32_t height,
     if (width < 1 || height < 1 || players < 1 || areas < 1) {
         return NULL;
     }
+    // BORDER nie może być numerem żadnego gracza
+    if (players >= BORDER) {
+        return NULL;
+    }
+    uint64_t fields = ((uint64_t)width + 2) * ((uint64_t)height + 2);
 
     gamma_t *g = malloc(sizeof(*g));
     if (g == NULL) {
@@ -30,580 +695,2095 @@ gamma_t *gamma_new(uint32_t width, uint32_t height,
     g->width = width;
     g->height = height;
     g->max_areas = areas;
+    g->hash = hash_mix(hash_mix((uint64_t)height << 32 | width) ^ ((uint64_t)players << 32 | areas));
 
     g->player_count = players;
-    g->players = malloc(players * sizeof(player));
-    if (g->players == NULL) {
+    // opisy graczy powstają dopiero przy ich pierwszym ruchu
+    if (!player_table_init(&g->players, players)) {
         free(g);
         return NULL;
     }
-    for (uint32_t i = 0; i < players; i++) {
-        g->players[i].busy_fields = 0;
-        g->players[i].free_fields = 0;
-        g->players[i].areas = 0;
-        g->players[i].golden_unused = true;
+    g->busy_count = 0;
+    g->spare_count = 0;
+    // BORDER musi być większy od numerów wszystkich graczy
+    if (players < UINT8_MAX) {
+        g->owner_size = sizeof(uint8_t);
+    } else if (players < UINT16_MAX) {
+        g->owner_size = sizeof(uint16_t);
+    } else {
+        g->owner_size = sizeof(uint32_t);
     }
+    g->tile_adjacent = NULL;
+    g->tile_keys = NULL;
+    field_map_init(&g->tiles);
 
-    g->board = malloc(width * sizeof(field));
-    if (g->board == NULL) {
-        free(g->players);
+    // indeksy pól są zarazem numerami węzłów, więc zbyt duża plansza musi składać się z kafelków;
+    // mniejsza składa się z nich tylko wtedy, gdy zabraknie pamięci na całą planszę naraz
+    g->tiled = fields >= NODE_LIMIT || !dense_board_init(g, fields);
+    if (g->tiled && !tiled_board_init(g)) {
+        free(g->owners);
+        free(g->roots);
+        free(g->tile_adjacent);
+        free(g->tile_keys);
+        field_map_destroy(&g->tiles);
+        player_table_destroy(&g->players);
         free(g);
         return NULL;
     }
-    for (uint32_t i = 0; i < width; i++) {
-        g->board[i] = malloc(height * sizeof(field));
-        if (g->board[i] == NULL) {
-            free(g->players);
-            for (uint32_t j = 0; j < i; j++) {
-                free(g->board[j]);
+    g->spare_roots = NULL;
+    g->spare_capacity = 0;
+    field_map_init(&g->moved);
+
+    g->regions = NULL;
+    g->region_count = 0;
+    g->region_capacity = 0;
+    g->free_region = NO_FIELD;
+    g->regions_tracked = false;
+
+    for (uint32_t i = 0; i < SPLIT_SEARCHES; i++) {
+        g->search.queue[i] = NULL;
+        g->search.capacity[i] = 0;
+    }
+    field_map_init(&g->search.visited);
+
+    g->risky_fields = NULL;
+    g->risky_count = 0;
+    g->risky_capacity = 0;
+    field_map_init(&g->risky_position);
+
+    // plansza bitowa jedynie przyspiesza wyznaczanie ruchów, więc gra może się bez niej obejść
+    g->bits = NULL;
+    if (width <= BITBOARD_SIDE && height <= BITBOARD_SIDE && players <= BITBOARD_PLAYERS) {
+        g->bits = malloc(sizeof(bitboard));
+        if (g->bits != NULL) {
+            bitboard_init(g->bits, width, height);
+        }
+    }
+
+    g->frontiers_tracked = false;
+    frontier_table_init(&g->frontiers);
+    frontier_table_init(&g->contacts);
+    memset(&g->journal, 0, sizeof(g->journal));
+
+    return g;
+}
+
+void gamma_delete(gamma_t *g) {
+    if (g != NULL) {
+        player_table_destroy(&g->players);
+        free(g->owners);
+        if (g->tiled) {
+            free(g->roots);
+        }
+        free(g->tile_adjacent);
+        free(g->tile_keys);
+        field_map_destroy(&g->tiles);
+        free(g->spare_roots);
+        field_map_destroy(&g->moved);
+        free(g->regions);
+        for (uint32_t i = 0; i < SPLIT_SEARCHES; i++) {
+            free(g->search.queue[i]);
+        }
+        field_map_destroy(&g->search.visited);
+        free(g->risky_fields);
+        field_map_destroy(&g->risky_position);
+        frontier_table_destroy(&g->frontiers);
+        frontier_table_destroy(&g->contacts);
+        free(g->bits);
+        journal_clear(&g->journal);
+        free(g);
+    }
+}
+
+/** @brief Kopiuje tablicę, zachowując jej rozmiar.
+ * @param[in] array    – kopiowana tablica, może być NULL,
+ * @param[in] capacity – rozmiar tablicy w elementach,
+ * @param[in] count    – liczba używanych elementów, które trzeba skopiować,
+ * @param[in] size     – rozmiar elementu w bajtach,
+ * @param[out] copy    – wskaźnik na miejsce na kopię, NULL dla pustej tablicy.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool copy_array(const void *array, uint64_t capacity, uint64_t count, size_t size, void **copy) {
+    *copy = NULL;
+    if (array == NULL || capacity == 0) {
+        return true;
+    }
+    *copy = malloc(capacity * size);
+    if (*copy == NULL) {
+        return false;
+    }
+    memcpy(*copy, array, count * size);
+    return true;
+}
+
+gamma_t *gamma_clone(gamma_t *g) {
+    if (g == NULL) {
+        return NULL;
+    }
+    gamma_t *c = malloc(sizeof(*c));
+    if (c == NULL) {
+        return NULL;
+    }
+    // najpierw kopia bez własnej pamięci, żeby gamma_delete mogło ją zwolnić w każdej chwili
+    *c = *g;
+    c->players.blocks = NULL;
+    c->players.block_count = 0;
+    c->owners = NULL;
+    c->roots = NULL;
+    c->tile_adjacent = NULL;
+    c->tile_keys = NULL;
+    field_map_init(&c->tiles);
+    c->spare_roots = NULL;
+    field_map_init(&c->moved);
+    c->regions = NULL;
+    for (uint32_t i = 0; i < SPLIT_SEARCHES; i++) {
+        c->search.queue[i] = NULL;
+        c->search.capacity[i] = 0;
+    }
+    field_map_init(&c->search.visited);
+    c->risky_fields = NULL;
+    field_map_init(&c->risky_position);
+    c->bits = NULL;
+    frontier_table_init(&c->frontiers);
+    frontier_table_init(&c->contacts);
+    memset(&c->journal, 0, sizeof(c->journal)); // kopia zaczyna bez historii ruchów
+
+    // numery węzłów i obszarów są indeksami, więc tablice kopiuje się bez zmian
+    bool copied;
+    if (g->tiled) {
+        copied = copy_array(g->owners, g->cell_capacity, g->cell_count, g->owner_size, (void **)&c->owners) &&
+                 copy_array(g->roots, g->cell_capacity, g->cell_count, sizeof(uint32_t), (void **)&c->roots) &&
+                 copy_array(g->tile_adjacent, g->cell_capacity / TILE_CELLS * SQUARE,
+                            g->cell_count / TILE_CELLS * SQUARE, sizeof(uint32_t), (void **)&c->tile_adjacent) &&
+                 copy_array(g->tile_keys, g->cell_capacity / TILE_CELLS, g->cell_count / TILE_CELLS,
+                            sizeof(uint64_t), (void **)&c->tile_keys) &&
+                 field_map_copy(&c->tiles, &g->tiles);
+    } else {
+        copied = copy_array(g->owners, dense_block_size(g), dense_block_size(g), 1, (void **)&c->owners);
+        if (copied) {
+            c->roots = (uint32_t *)((char *)c->owners + ((char *)g->roots - (char *)g->owners));
+        }
+    }
+    copied = copied && player_table_copy(&c->players, &g->players) &&
+             copy_array(g->spare_roots, g->spare_capacity, g->spare_count, sizeof(uint32_t),
+                        (void **)&c->spare_roots) &&
+             field_map_copy(&c->moved, &g->moved) &&
+             copy_array(g->regions, g->region_capacity, g->region_count, sizeof(region), (void **)&c->regions) &&
+             copy_array(g->risky_fields, g->risky_capacity, g->risky_count, sizeof(uint32_t),
+                        (void **)&c->risky_fields) &&
+             field_map_copy(&c->risky_position, &g->risky_position) &&
+             frontier_table_copy(&c->frontiers, &g->frontiers) &&
+             frontier_table_copy(&c->contacts, &g->contacts) &&
+             copy_array(g->bits, 1, 1, sizeof(bitboard), (void **)&c->bits);
+    if (!copied) {
+        gamma_delete(c);
+        return NULL;
+    }
+    return c;
+}
+
+/** @brief Podaje ilość pól należacych do danego gracza sąsiadujących z danym polem.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] field   – indeks pola planszy.
+ */
+static uint32_t owner_fields_neighbouring(gamma_t *g, uint32_t player, uint32_t field) {
+    uint32_t owner_fields_neighbouring = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == player)
+            owner_fields_neighbouring++;
+    }
+    return owner_fields_neighbouring;
+}
+
+/** @brief Zapewnia miejsce na nowe opisy obszarów.
+ * Powiększa tablicę opisów obszarów tak, aby dało się utworzyć
+ * @p count nowych obszarów bez alokowania pamięci.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] count   – liczba potrzebnych opisów.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool reserve_regions(gamma_t *g, uint32_t count) {
+    if ((uint64_t)g->region_count + count <= g->region_capacity) {
+        return true;
+    }
+    uint64_t capacity = 2 * (uint64_t)g->region_capacity;
+    if (capacity < (uint64_t)g->region_count + count) {
+        capacity = (uint64_t)g->region_count + count;
+    }
+    if (capacity < MIN_REGIONS) {
+        capacity = MIN_REGIONS;
+    }
+    if (capacity > NODE_LIMIT) {
+        capacity = NODE_LIMIT;
+    }
+    if (capacity < (uint64_t)g->region_count + count) {
+        return false;
+    }
+    region *regions = realloc(g->regions, capacity * sizeof(region));
+    if (regions == NULL) {
+        return false;
+    }
+    g->regions = regions;
+    g->region_capacity = capacity;
+    return true;
+}
+
+/** @brief Zapewnia miejsce na nowe węzły zapasowe.
+ * Węzły zapasowe mają numery od NODE_LIMIT - 1 w dół, więc nie mogą
+ * zejść do numerów węzłów pól planszy (także kafelków tworzonych później).
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] count   – liczba potrzebnych węzłów.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool reserve_spare_nodes(gamma_t *g, uint64_t count) {
+    uint64_t fields = g->cell_count;
+    if (fields + g->spare_count + count > NODE_LIMIT) {
+        return false;
+    }
+    if (g->spare_count + count <= g->spare_capacity) {
+        return field_map_reserve(&g->moved, count);
+    }
+    uint64_t capacity = 2 * (uint64_t)g->spare_capacity;
+    if (capacity < g->spare_count + count) {
+        capacity = g->spare_count + count;
+    }
+    if (capacity > NODE_LIMIT - fields) {
+        capacity = NODE_LIMIT - fields;
+    }
+    uint32_t *spare_roots = realloc(g->spare_roots, capacity * sizeof(uint32_t));
+    if (spare_roots == NULL) {
+        return false;
+    }
+    g->spare_roots = spare_roots;
+    g->spare_capacity = capacity;
+    return field_map_reserve(&g->moved, count);
+}
+
+/** @brief Podaje wskaźnik na węzeł o danym numerze.
+ */
+static inline uint32_t *node_slot(gamma_t *g, uint32_t node) {
+    if (node < NODE_LIMIT - g->spare_count) {
+        return &g->roots[node];
+    }
+    return &g->spare_roots[NODE_LIMIT - 1 - node];
+}
+
+/** @brief Ustawia zawartość węzła, zachowując znacznik MOVED_FLAG.
+ */
+static inline void set_node(gamma_t *g, uint32_t node, uint32_t value) {
+    uint32_t *slot = node_slot(g, node);
+    journal_record(g, JOURNAL_NODE, node, *slot);
+    *slot = (*slot & MOVED_FLAG) | value;
+}
+
+/** @brief Podaje numer węzła, który reprezentuje pole w drzewie obszaru.
+ * Zwykle jest to węzeł o numerze równym indeksowi pola, chyba że pole
+ * zostało odłączone od obszaru i dostało węzeł zapasowy.
+ */
+static inline uint32_t field_node(gamma_t *g, uint32_t field) {
+    if (g->roots[field] & MOVED_FLAG) {
+        uint32_t node = 0;
+        field_map_get(&g->moved, field, &node);
+        return node;
+    }
+    return field;
+}
+
+/** @brief Nadaje polu nowy węzeł zapasowy.
+ * Dotychczasowy węzeł pola zostaje w swoim drzewie, bo mogą przez niego
+ * przechodzić ścieżki innych pól. Miejsce na węzeł musi być wcześniej
+ * zapewnione przez @ref reserve_spare_nodes.
+ * @return numer nowego węzła pola
+ */
+static uint32_t move_field(gamma_t *g, uint32_t field) {
+    assert(g->spare_count < g->spare_capacity);
+    g->spare_count++;
+    uint32_t node = NODE_LIMIT - g->spare_count;
+    g->spare_roots[g->spare_count - 1] = 0;
+    journal_record_map(g, JOURNAL_MOVED, &g->moved, field);
+    field_map_set(&g->moved, field, node);
+    journal_record(g, JOURNAL_NODE, field, g->roots[field]);
+    g->roots[field] |= MOVED_FLAG;
+    return node;
+}
+
+/** @brief Podaje opis obszaru, którego reprezentantem jest węzeł @p root.
+ */
+static inline region *root_region(gamma_t *g, uint32_t root) {
+    return &g->regions[*node_slot(g, root) & NODE_MASK];
+}
+
+/** @brief Podaje do zmiany opis obszaru, którego reprezentantem jest węzeł @p root.
+ * Opis jest najpierw zapamiętywany w dzienniku.
+ */
+static inline region *region_change(gamma_t *g, uint32_t root) {
+    region *r = root_region(g, root);
+    journal_save_region(g, r - g->regions);
+    return r;
+}
+
+/** @brief Zmienia liczbę pól obszaru, którego reprezentantem jest węzeł @p root.
+ */
+static inline void region_resize(gamma_t *g, uint32_t root, uint64_t size) {
+    region_change(g, root)->size = size;
+}
+
+/** @brief Rozszerza prostokąt obszaru tak, aby obejmował pole.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in,out] r   – wskaźnik na opis obszaru,
+ * @param[in] field   – indeks pola planszy.
+ */
+static void region_extend(gamma_t *g, region *r, uint32_t field) {
+    uint32_t x, y;
+    field_coordinates(g, field, &x, &y);
+    if (x < r->min_x) {
+        r->min_x = x;
+    }
+    if (x > r->max_x) {
+        r->max_x = x;
+    }
+    if (y < r->min_y) {
+        r->min_y = y;
+    }
+    if (y > r->max_y) {
+        r->max_y = y;
+    }
+}
+
+/** @brief Tworzy nowy obszar z reprezentantem w węźle @p node.
+ * Prostokąt obszaru obejmuje na razie tylko pole @p field, a obszar nie ma
+ * wolnych sąsiadów. Miejsce na opis obszaru musi być wcześniej zapewnione
+ * przez @ref reserve_regions.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] node    – węzeł, który zostaje reprezentantem obszaru,
+ * @param[in] owner   – właściciel obszaru,
+ * @param[in] field   – indeks jednego z pól obszaru,
+ * @param[in] size    – liczba pól obszaru.
+ * @return wskaźnik na opis obszaru
+ */
+static region *region_new(gamma_t *g, uint32_t node, uint32_t owner, uint32_t field, uint64_t size) {
+    uint32_t id;
+    if (g->free_region != NO_FIELD) {
+        id = g->free_region;
+        g->free_region = g->regions[id].size;
+    } else {
+        assert(g->region_count < g->region_capacity);
+        id = g->region_count++;
+    }
+    journal_save_region(g, id);
+    region *r = &g->regions[id];
+    r->size = size;
+    r->frontier = 0;
+    r->owner = owner;
+    r->anchor = field;
+    field_coordinates(g, field, &r->min_x, &r->min_y);
+    r->max_x = r->min_x;
+    r->max_y = r->min_y;
+    r->stale = !g->regions_tracked;
+    set_node(g, node, ROOT_FLAG | id);
+    return r;
+}
+
+/** @brief Zwalnia opis obszaru, którego reprezentantem jest węzeł @p root.
+ * Wolne opisy tworzą listę połączoną przez pole @p size.
+ */
+static void region_free(gamma_t *g, uint32_t root) {
+    region *r = region_change(g, root);
+    r->size = g->free_region;
+    r->owner = NONE;
+    g->free_region = r - g->regions;
+}
+
+/** @brief Znajduje reprezentanta obszaru, do którego należy węzeł.
+ * Funkcja iteracyjnie przechodzi ścieżkę do reprezentanta,
+ * skracając ją o połowę (każdy odwiedzony węzeł zaczyna wskazywać na dziadka).
+ * @return numer węzła reprezentanta
+ */
+static uint32_t find_root(gamma_t *g, uint32_t node) {
+    uint32_t *slot = node_slot(g, node);
+    while (!(*slot & ROOT_FLAG)) {
+        uint32_t parent = *slot & NODE_MASK;
+        uint32_t *parent_slot = node_slot(g, parent);
+        if (*parent_slot & ROOT_FLAG) {
+            return parent;
+        }
+        // skrócona ścieżka mogłaby po cofnięciu ruchu prowadzić do złego reprezentanta
+        journal_record(g, JOURNAL_NODE, node, *slot);
+        node = *parent_slot & NODE_MASK;
+        *slot = (*slot & MOVED_FLAG) | node;
+        slot = node_slot(g, node);
+    }
+    return node;
+}
+
+/** @brief Znajduje reprezentanta obszaru, do którego należy pole.
+ */
+static inline uint32_t field_root(gamma_t *g, uint32_t field) {
+    return find_root(g, field_node(g, field));
+}
+
+/** @brief Łączy dwa obszary.
+ * Mniejszy obszar zostaje podpięty pod reprezentanta większego. Prostokąt
+ * połączonego obszaru obejmuje oba prostokąty, a liczba wolnych sąsiadów
+ * zostanie przeliczona przy pierwszym pytaniu o obszar.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] a, b    – reprezentanci dwóch różnych obszarów.
+ * @return reprezentant połączonego obszaru
+ */
+static uint32_t merge_regions(gamma_t *g, uint32_t a, uint32_t b) {
+    if (root_region(g, a)->size < root_region(g, b)->size) {
+        uint32_t c = a;
+        a = b;
+        b = c;
+    }
+    region *merged = region_change(g, a);
+    const region *other = root_region(g, b);
+    merged->size += other->size;
+    merged->min_x = other->min_x < merged->min_x ? other->min_x : merged->min_x;
+    merged->min_y = other->min_y < merged->min_y ? other->min_y : merged->min_y;
+    merged->max_x = other->max_x > merged->max_x ? other->max_x : merged->max_x;
+    merged->max_y = other->max_y > merged->max_y ? other->max_y : merged->max_y;
+    // wolne pole może sąsiadować z oboma obszarami, czego nie da się sprawdzić bez ich przejrzenia
+    merged->stale = true;
+    region_free(g, b);
+    set_node(g, b, a);
+    return a;
+}
+
+/** @brief Sprawdza, czy pole sąsiaduje z polem obszaru innym niż @p except.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – właściciel obszaru,
+ * @param[in] root    – reprezentant obszaru,
+ * @param[in] field   – indeks pola planszy,
+ * @param[in] except  – indeks pomijanego pola.
+ * @return Wartość @p true, jeśli pole sąsiaduje z obszarem, a @p false wpp.
+ */
+static bool region_touches(gamma_t *g, uint32_t player, uint32_t root, uint32_t field, uint32_t except) {
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (neighbour[i] != except && owner_get(g, neighbour[i]) == player &&
+            field_root(g, neighbour[i]) == root) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Podaje liczbę wolnych sąsiadów pola, które nie sąsiadują z innym polem obszaru.
+ * Tylu wolnych sąsiadów przybywa obszarowi, gdy dołącza do niego pole @p field.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – właściciel obszaru,
+ * @param[in] root    – reprezentant obszaru,
+ * @param[in] field   – indeks pola planszy.
+ * @return liczba takich pól
+ */
+static uint64_t region_new_frontier(gamma_t *g, uint32_t player, uint32_t root, uint32_t field) {
+    uint64_t count = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == NONE && !region_touches(g, player, root, neighbour[i], field)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/** @brief Odlicza pole od wolnych sąsiadów obszarów, z którymi sąsiaduje.
+ * Wywoływana, gdy wolne pole zostaje zajęte. Zanim ruchy zaczną poprawiać opisy
+ * obszarów, opisy są tylko zapamiętywane w dzienniku, żeby cofnięcie ruchu
+ * przywróciło je jako nieaktualne także wtedy, gdy w międzyczasie zostały przeliczone.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field   – indeks pola planszy.
+ */
+static void regions_lose_frontier(gamma_t *g, uint32_t field) {
+    if (!g->regions_tracked && !g->journal.enabled) {
+        return;
+    }
+    uint32_t root[NEIGHBOURS];
+    uint32_t roots = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        uint32_t owner = owner_get(g, neighbour[i]);
+        if (owner == NONE || owner == BORDER) {
+            continue;
+        }
+        uint32_t neighbour_root = field_root(g, neighbour[i]);
+        bool unique = true;
+        for (uint32_t j = 0; j < roots; j++) {
+            if (root[j] == neighbour_root)
+                unique = false;
+        }
+        if (unique) {
+            root[roots++] = neighbour_root;
+            region_change(g, neighbour_root)->frontier--;
+        }
+    }
+}
+
+/** @brief Dołącza pole do obszaru.
+ * Funkcja ustawia rodzica węzła danego pola na reprezentanta
+ * obszaru do którego pole jest przyłączane. Opis obszaru zyskuje to pole
+ * i jego wolnych sąsiadów, z którymi obszar jeszcze nie sąsiadował.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] field   – indeks pola planszy.
+ * @return reprezentant obszaru, do którego dołączono pole
+ */
+static uint32_t unite_single(gamma_t *g, uint32_t player, uint32_t field) {
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == player) {
+            uint32_t root = field_root(g, neighbour[i]);
+            set_node(g, field_node(g, field), root);
+            region *r = region_change(g, root);
+            r->size++;
+            if (g->regions_tracked) {
+                r->frontier += region_new_frontier(g, player, root, field);
+                region_extend(g, r, field);
+            }
+            return root;
+        }
+    }
+    return NO_FIELD;
+}
+
+/** @brief Dołącza pole do obszaru, łączy obszary.
+ * Funkcja ustawia rodzica węzła danego pola na reprezentanta
+ * jednego z obszarów gracza z którymi sąsiaduje.
+ *
+ * W wypadku, w którym nowo zajęte pole
+ * sąsiaduje z rozłącznymi obszarami gracza łączy je,
+ * zmiejszając parametr areas gracza i podpinając
+ * mniejsze obszary pod reprezentanta większego.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] field   – indeks pola planszy.
+ */
+static void unite_multiple(gamma_t *g, uint32_t player, uint32_t field) {
+    uint32_t root = unite_single(g, player, field);
+
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == player) {
+            uint32_t neighbour_root = field_root(g, neighbour[i]);
+            if (neighbour_root != root) {
+                player_at(g, player)->areas--;
+                root = merge_regions(g, root, neighbour_root);
+            }
+        }
+    }
+}
+
+/** @brief Przyłącza świeżo zajęte pole do obszarów gracza.
+ * Pole zostaje samodzielnym obszarem lub dołącza do sąsiednich obszarów gracza,
+ * łącząc je. Liczba obszarów gracza jest odpowiednio poprawiana.
+ * Jeśli pole tworzy nowy obszar, miejsce na jego opis musi być
+ * wcześniej zapewnione przez @ref reserve_regions.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, właściciel pola,
+ * @param[in] field   – indeks pola planszy.
+ */
+static void attach_field(gamma_t *g, uint32_t player, uint32_t field) {
+    uint32_t own_fields_neighbouring = owner_fields_neighbouring(g, player, field);
+    if (own_fields_neighbouring == 0) {
+        //pole staje się reprezentanem nowego obszaru
+        player_at(g, player)->areas++;
+        region_new(g, field_node(g, field), player, field, 1)->frontier =
+                owner_fields_neighbouring(g, NONE, field);
+    } else if (own_fields_neighbouring == 1) {
+        unite_single(g, player, field);
+    } else {
+        unite_multiple(g, player, field);
+    }
+}
+
+/** @brief Podaje liczbe nowych sąsiednich wolnych pól.
+ * Funkcja podaje liczbę pól sąsiadujących z nim, które są
+ * niezajęte i nie sąsiadują z żadnym polem zajętym przez danego gracza.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] field   – indeks pola planszy.
+ * @return liczba nowych sąsiednich wolnych pól
+ */
+static uint64_t new_free_fields(gamma_t *g, uint32_t player, uint32_t field) {
+    uint64_t new_free_fields = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == NONE)
+            if (owner_fields_neighbouring(g, player, neighbour[i]) == 0)
+                new_free_fields++;
+    }
+
+    return new_free_fields;
+}
+
+/** @brief Zapewnia miejsce na zmianę właściciela jednego pola w indeksie złotych ruchów.
+ * Zmiana właściciela pola może dopisać do zbioru pól ryzykownych
+ * najwyżej wszystkie pola kwadratu 3 na 3 wokół niego.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool reserve_golden_index(gamma_t *g) {
+    if ((uint64_t)g->risky_count + SQUARE > g->risky_capacity) {
+        uint64_t capacity = 2 * (uint64_t)g->risky_capacity;
+        if (capacity < MIN_REGIONS) {
+            capacity = MIN_REGIONS;
+        }
+        if (capacity > NODE_LIMIT) {
+            capacity = NODE_LIMIT;
+        }
+        uint32_t *risky_fields = realloc(g->risky_fields, capacity * sizeof(uint32_t));
+        if (risky_fields == NULL) {
+            return false;
+        }
+        g->risky_fields = risky_fields;
+        g->risky_capacity = capacity;
+    }
+    return field_map_reserve(&g->risky_position, SQUARE);
+}
+
+/** @brief Sprawdza, czy odebranie pola na pewno nie rozspójni obszaru właściciela.
+ * Wystarczy, że sąsiedzi pola należący do właściciela są połączeni
+ * polami właściciela spośród ośmiu pól otaczających dane pole.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] owner   – numer gracza, właściciel pola,
+ * @param[in] field   – indeks pola planszy.
+ * @return Wartość @p true, jeśli obszar na pewno się nie rozpadnie, a @p false wpp.
+ */
+static bool locally_connected(gamma_t *g, uint32_t owner, uint32_t field) {
+    // na zmianę sąsiad i pole narożne, zgodnie z ruchem wskazówek zegara od górnego sąsiada
+    uint32_t ring[RING] = {cell_at(g, field, 0, 1), cell_at(g, field, 1, 1),
+                           cell_at(g, field, 1, 0), cell_at(g, field, 1, -1),
+                           cell_at(g, field, 0, -1), cell_at(g, field, -1, -1),
+                           cell_at(g, field, -1, 0), cell_at(g, field, -1, 1)};
+    uint32_t sides = 0;
+    uint32_t links = 0;
+    for (uint32_t i = 0; i < RING; i += 2) {
+        if (owner_get(g, ring[i]) == owner) {
+            sides++;
+            if (owner_get(g, ring[i + 1]) == owner && owner_get(g, ring[(i + 2) % RING]) == owner) {
+                links++;
+            }
+        }
+    }
+    // cztery połączenia oznaczają pełny pierścień, czyli też jedną część
+    return sides <= links + 1;
+}
+
+/** @brief Dolicza lub odlicza wkład pola do indeksu złotych ruchów.
+ * Pole gracza jest celem złotego ruchu dla każdego innego gracza, z którego polem
+ * sąsiaduje. Cel jest bezpieczny, jeśli jego odebranie na pewno nie rozspójni
+ * obszaru właściciela, a pozostałe cele trafiają do zbioru pól ryzykownych.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field   – indeks pola, także pola ramki,
+ * @param[in] add     – @p true, jeśli wkład jest doliczany, a @p false, jeśli odliczany.
+ */
+static void golden_index_update(gamma_t *g, uint32_t field, bool add) {
+    uint32_t owner = owner_get(g, field);
+    if (owner == NONE || owner == BORDER) {
+        return;
+    }
+    uint32_t attacker[NEIGHBOURS];
+    uint32_t attackers = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        uint32_t neighbour_owner = owner_get(g, neighbour[i]);
+        if (neighbour_owner == NONE || neighbour_owner == BORDER || neighbour_owner == owner) {
+            continue;
+        }
+        bool unique = true;
+        for (uint32_t j = 0; j < attackers; j++) {
+            if (attacker[j] == neighbour_owner)
+                unique = false;
+        }
+        if (unique)
+            attacker[attackers++] = neighbour_owner;
+    }
+    if (attackers == 0) {
+        return;
+    }
+
+    bool safe = locally_connected(g, owner, field);
+    for (uint32_t i = 0; i < attackers; i++) {
+        player *p = player_at(g, attacker[i]);
+        if (add) {
+            p->golden_targets++;
+            p->safe_golden_targets += safe;
+        } else {
+            p->golden_targets--;
+            p->safe_golden_targets -= safe;
+        }
+    }
+    if (safe) {
+        return;
+    }
+    if (add) {
+        journal_record_map(g, JOURNAL_RISKY_POSITION, &g->risky_position, field);
+        field_map_set(&g->risky_position, field, g->risky_count);
+        g->risky_fields[g->risky_count++] = field;
+    } else {
+        uint32_t position = 0;
+        field_map_get(&g->risky_position, field, &position);
+        uint32_t last = g->risky_fields[--g->risky_count];
+        journal_record(g, JOURNAL_RISKY, position, g->risky_fields[position]);
+        g->risky_fields[position] = last;
+        journal_record_map(g, JOURNAL_RISKY_POSITION, &g->risky_position, last);
+        field_map_set(&g->risky_position, last, position);
+        journal_record_map(g, JOURNAL_RISKY_POSITION, &g->risky_position, field);
+        field_map_remove(&g->risky_position, field);
+    }
+}
+
+/** @brief Zmienia właściciela pola, poprawiając indeks złotych ruchów.
+ * Zmiana wpływa na wkład pól kwadratu 3 na 3 wokół pola, więc ich wkład jest
+ * odliczany przed zmianą i doliczany po niej. Miejsce w indeksie musi być
+ * wcześniej zapewnione przez @ref reserve_golden_index.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field   – indeks pola planszy,
+ * @param[in] owner   – nowy właściciel pola.
+ */
+static void set_owner(gamma_t *g, uint32_t field, uint32_t owner) {
+    uint32_t square[SQUARE];
+    for (int i = 0; i < SQUARE; i++) {
+        square[i] = cell_at(g, field, i % 3 - 1, i / 3 - 1);
+        golden_index_update(g, square[i], false);
+    }
+    journal_record(g, JOURNAL_OWNER, field, owner_get(g, field));
+    bits_set_owner(g, field, owner);
+    owner_set(g, field, owner);
+    for (uint32_t i = 0; i < SQUARE; i++) {
+        golden_index_update(g, square[i], true);
+    }
+}
+
+/** @brief Ustawia pole jako zajęte
+ * Funkcja sprawia, że dany gracz staje się właścicielem danego pola,
+ * jego liczba zajętych pól zwiększa się o jeden, a liczba sąsiednich wolnych pól
+ * innych graczy, którzy sąsiadują z tym polem zmniejsza się o jeden.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] field   – indeks pola planszy.
+ */
+static void make_field_busy(gamma_t *g, uint32_t player, uint32_t field) {
+    set_owner(g, field, player);
+    player_at(g, player)->busy_fields++;
+    uint32_t owner[NEIGHBOURS] = {NONE, NONE, NONE, NONE};
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        uint32_t neighbour_owner = owner_get(g, neighbour[i]);
+        if (neighbour_owner != player && neighbour_owner != NONE && neighbour_owner != BORDER) {
+            owner[i] = neighbour_owner;
+            bool unique = true;
+            /*
+             * nie zabieramy wolnego pola danemu graczowi
+             * więcej niż raz
+             */
+            for (uint32_t j = 0; j < i; j++) {
+                if (owner[i] == owner[j])
+                    unique = false;
+            }
+            if (unique)
+                player_at(g, owner[i])->free_fields--;
+        }
+    }
+}
+
+/** @brief Przynależność pola ruchu i jego sąsiadów do zbiorów graczy.
+ * Wolne pole należy do zbiorów @p frontiers, a zajęte do zbiorów @p contacts
+ * graczy, których pola z nim sąsiadują, oprócz jego właściciela. Ruch zmienia
+ * właściciela jednego pola, więc zmienia przynależność tylko jego i jego sąsiadów.
+ */
+typedef struct {
+    uint32_t field[NEIGHBOURS + 1];               ///< pole ruchu i jego sąsiedzi
+    bool busy[NEIGHBOURS + 1];                    ///< true, jeśli pole jest zajęte
+    uint32_t players[NEIGHBOURS + 1][NEIGHBOURS]; ///< gracze, w których zbiorach jest pole
+    uint32_t count[NEIGHBOURS + 1];               ///< liczba tych graczy
+} frontier_view;
+
+/** @brief Wyznacza graczy, w których zbiorach powinno być pole.
+ * @param[in] g         – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] field     – indeks pola,
+ * @param[out] players  – tablica na numery graczy.
+ * @return liczba graczy
+ */
+static uint32_t frontier_players(gamma_t *g, uint32_t field, uint32_t players[NEIGHBOURS]) {
+    uint32_t owner = owner_get(g, field);
+    if (owner == BORDER) {
+        return 0;
+    }
+    uint32_t count = 0;
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t j = 0; j < NEIGHBOURS; j++) {
+        uint32_t player = owner_get(g, neighbour[j]);
+        bool listed = player == NONE || player == BORDER || player == owner;
+        for (uint32_t k = 0; k < count && !listed; k++) {
+            listed = players[k] == player;
+        }
+        if (!listed) {
+            players[count++] = player;
+        }
+    }
+    return count;
+}
+
+/** @brief Odczytuje przynależność pola @p field i jego sąsiadów do zbiorów graczy.
+ * Nic nie robi, jeśli zbiory nie są utrzymywane.
+ */
+static void frontier_view_read(gamma_t *g, uint32_t field, frontier_view *view) {
+    if (!g->frontiers_tracked) {
+        return;
+    }
+    view->field[0] = field;
+    neighbours(g, field, view->field + 1);
+    for (uint32_t i = 0; i <= NEIGHBOURS; i++) {
+        view->busy[i] = owner_get(g, view->field[i]) != NONE;
+        view->count[i] = frontier_players(g, view->field[i], view->players[i]);
+    }
+}
+
+/** @brief Sprawdza, czy gracz jest na liście graczy pola z @p view.
+ */
+static inline bool frontier_view_lists(const frontier_view *view, uint32_t i, uint32_t player) {
+    for (uint32_t k = 0; k < view->count[i]; k++) {
+        if (view->players[i][k] == player) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Poprawia zbiory graczy po zmianie właściciela pola.
+ * Miejsce w zbiorach musi być wcześniej zapewnione przez @ref reserve_frontiers.
+ * @param[in,out] g    – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] before   – przynależność pól odczytana przed zmianą.
+ */
+static void frontier_view_update(gamma_t *g, const frontier_view *before) {
+    if (!g->frontiers_tracked) {
+        return;
+    }
+    frontier_view after;
+    frontier_view_read(g, before->field[0], &after);
+    for (uint32_t i = 0; i <= NEIGHBOURS; i++) {
+        bool same_kind = before->busy[i] == after.busy[i];
+        frontier_table *old_table = before->busy[i] ? &g->contacts : &g->frontiers;
+        frontier_table *new_table = after.busy[i] ? &g->contacts : &g->frontiers;
+        for (uint32_t k = 0; k < before->count[i]; k++) {
+            if (!same_kind || !frontier_view_lists(&after, i, before->players[i][k])) {
+                frontier_table_remove(old_table, before->players[i][k], before->field[i]);
+            }
+        }
+        for (uint32_t k = 0; k < after.count[i]; k++) {
+            if (!same_kind || !frontier_view_lists(before, i, after.players[i][k])) {
+                frontier_table_insert(new_table, after.players[i][k], after.field[i]);
+            }
+        }
+    }
+}
+
+/** @brief Zapewnia miejsce w zbiorach graczy na ruch gracza @p player na pole @p field.
+ * Zbiory gracza mogą zyskać po jednym polu na każdego sąsiada, a zbiory właścicieli
+ * pola i jego sąsiadów – najwyżej samo pole.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool reserve_frontiers(gamma_t *g, uint32_t player, uint32_t field) {
+    if (!g->frontiers_tracked) {
+        return true;
+    }
+    if (!frontier_table_reserve(&g->frontiers, player, NEIGHBOURS) ||
+        !frontier_table_reserve(&g->contacts, player, NEIGHBOURS)) {
+        return false;
+    }
+    uint32_t cross[NEIGHBOURS + 1];
+    cross[0] = field;
+    neighbours(g, field, cross + 1);
+    for (uint32_t i = 0; i <= NEIGHBOURS; i++) {
+        uint32_t owner = owner_get(g, cross[i]);
+        if (owner != NONE && owner != BORDER && owner != player &&
+            !frontier_table_reserve(&g->contacts, owner, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Zaczyna utrzymywać zbiory graczy, wypełniając je na podstawie planszy.
+ * Zbiory są potrzebne tylko do wyznaczania możliwych ruchów, więc gra, która
+ * tego nie robi, nie płaci za ich poprawianie przy każdym ruchu. Wszystkie pola
+ * zbiorów są zajęte lub sąsiadują z zajętym, więc wystarczy przejrzeć zajęte pola.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool track_frontiers(gamma_t *g) {
+    if (g->frontiers_tracked) {
+        return true;
+    }
+    uint32_t players[NEIGHBOURS];
+    uint32_t neighbour[NEIGHBOURS];
+    for (uint32_t field = 0; field < g->cell_count; field++) {
+        uint32_t owner = owner_get(g, field);
+        if (owner == NONE || owner == BORDER) {
+            continue;
+        }
+        bool reserved = frontier_table_reserve(&g->frontiers, owner, NEIGHBOURS);
+        uint32_t count = frontier_players(g, field, players);
+        for (uint32_t i = 0; i < count && reserved; i++) {
+            reserved = frontier_table_reserve(&g->contacts, players[i], 1);
+            if (reserved) {
+                frontier_table_insert(&g->contacts, players[i], field);
+            }
+        }
+        neighbours(g, field, neighbour);
+        for (uint32_t i = 0; i < NEIGHBOURS && reserved; i++) {
+            if (owner_get(g, neighbour[i]) == NONE && !frontier_table_contains(&g->frontiers, owner, neighbour[i])) {
+                frontier_table_insert(&g->frontiers, owner, neighbour[i]);
+            }
+        }
+        if (!reserved) {
+            frontier_table_destroy(&g->frontiers);
+            frontier_table_destroy(&g->contacts);
+            return false;
+        }
+    }
+    g->frontiers_tracked = true;
+    return true;
+}
+
+/** @brief Zajmuje wolne pole, nie sprawdzając limitu obszarów.
+ * Poprawia liczby wolnych pól graczy, indeks złotych ruchów, obszary gracza
+ * i zbiory graczy. Miejsce na opis obszaru, w indeksie złotych ruchów, w zbiorach
+ * graczy i opis gracza musi być wcześniej zapewnione.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, nowy właściciel pola,
+ * @param[in] field   – indeks wolnego pola planszy.
+ */
+static void occupy_field(gamma_t *g, uint32_t player, uint32_t field) {
+    frontier_view view;
+    frontier_view_read(g, field, &view);
+    if (owner_fields_neighbouring(g, player, field) > 0) {
+        player_at(g, player)->free_fields += new_free_fields(g, player, field) - 1;
+    } else {
+        player_at(g, player)->free_fields += new_free_fields(g, player, field);
+    }
+    make_field_busy(g, player, field);
+    regions_lose_frontier(g, field);
+    attach_field(g, player, field);
+    g->busy_count++;
+    frontier_view_update(g, &view);
+}
+
+/** @brief Sprawdza, czy pole (@p x, @p y) sąsiaduje z polem gracza.
+ * W przeciwieństwie do @ref owner_fields_neighbouring nie wymaga, żeby
+ * kafelki wokół pola były utworzone.
+ */
+static bool player_neighbours_at(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    return (x > 0 && owner_at(g, x - 1, y) == player) ||
+           (y > 0 && owner_at(g, x, y - 1) == player) ||
+           (x + 1 < g->width && owner_at(g, x + 1, y) == player) ||
+           (y + 1 < g->height && owner_at(g, x, y + 1) == player);
+}
+
+bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (!valid_player(g, player) || x >= g->width || y >= g->height) {
+        return false;
+    }
+    if (owner_at(g, x, y) != NONE) {
+        return false;
+    }
+    // ruch, który i tak byłby nielegalny, nie powinien tworzyć kafelków
+    if (g->tiled && player_info(g, player)->areas >= g->max_areas &&
+        !player_neighbours_at(g, player, x, y)) {
+        return false;
+    }
+    if (!materialize_tiles(g, x, y) || !reserve_golden_index(g) ||
+        player_table_touch(&g->players, player) == NULL || !reserve_journal(g, 0)) {
+        return false;
+    }
+    uint32_t field = board_cell(g, x, y);
+    if (owner_fields_neighbouring(g, player, field) == 0 &&
+        (player_at(g, player)->areas >= g->max_areas || !reserve_regions(g, 1))) {
+        return false;
+    }
+    if (!reserve_frontiers(g, player, field)) {
+        return false;
+    }
+    journal_begin(g, player, x, y, field);
+    occupy_field(g, player, field);
+    hash_field(g, x, y, player);
+    return true;
+}
+
+/** @brief Dopisuje pole do kolejki przeszukiwania.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+static bool search_push(split_search *s, uint32_t search, uint32_t field) {
+    if (s->length[search] == s->capacity[search]) {
+        uint64_t capacity = s->capacity[search] < MIN_REGIONS ? MIN_REGIONS : 2 * (uint64_t)s->capacity[search];
+        if (capacity > NODE_LIMIT) {
+            capacity = NODE_LIMIT;
+        }
+        uint32_t *queue = realloc(s->queue[search], capacity * sizeof(uint32_t));
+        if (queue == NULL) {
+            return false;
+        }
+        s->queue[search] = queue;
+        s->capacity[search] = capacity;
+    }
+    s->queue[search][s->length[search]++] = field;
+    return true;
+}
+
+/** @brief Podaje przeszukiwanie reprezentujące grupę danego przeszukiwania.
+ */
+static uint32_t search_group(split_search *s, uint32_t search) {
+    while (s->group[search] != search) {
+        search = s->group[search];
+    }
+    return search;
+}
+
+/** @brief Sprawdza, czy wszystkie przeszukiwania grupy się zakończyły.
+ */
+static bool group_finished(split_search *s, uint32_t group) {
+    for (uint32_t i = 0; i < s->searches; i++) {
+        if (search_group(s, i) == group && s->head[i] < s->length[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Podaje liczbę pól odwiedzonych przez przeszukiwania grupy.
+ */
+static uint64_t group_size(split_search *s, uint32_t group) {
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < s->searches; i++) {
+        if (search_group(s, i) == group) {
+            size += s->length[i];
+        }
+    }
+    return size;
+}
+
+/** @brief Sprawdza, na ile części rozpadnie się obszar po odebraniu z niego pola.
+ * Z każdego sąsiada pola należącego do gracza rusza przeszukiwanie wszerz
+ * po polach gracza z pominięciem samego pola. Przeszukiwania wykonują kroki
+ * na zmianę, a spotykając się, łączą się w grupy. Praca kończy się, gdy zostanie
+ * jedna grupa (obszar się nie rozpada) albo najwyżej jedna grupa nie została
+ * przeszukana do końca – to ona jest największą częścią, a koszt jest ograniczony
+ * przez rozmiar pozostałych części. Wynik zostaje w @p g->search.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, właściciel obszaru,
+ * @param[in] field   – indeks odbieranego pola.
+ * @return liczba części, na które rozpadnie się obszar (0, gdy pole
+ * jest samodzielnym obszarem) lub SEARCH_FAILED, gdy zabrakło pamięci
+ */
+static uint32_t count_parts(gamma_t *g, uint32_t player, uint32_t field) {
+    split_search *s = &g->search;
+    field_map_clear(&s->visited);
+    s->searches = 0;
+    s->moved_fields = 0;
+
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    if (!field_map_reserve(&s->visited, NEIGHBOURS)) {
+        return SEARCH_FAILED;
+    }
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == player) {
+            uint32_t search = s->searches++;
+            s->head[search] = 0;
+            s->length[search] = 0;
+            s->group[search] = search;
+            if (!search_push(s, search, neighbour[i])) {
+                return SEARCH_FAILED;
+            }
+            field_map_set(&s->visited, neighbour[i], search);
+        }
+    }
+    s->keep = 0;
+    if (s->searches <= 1) {
+        return s->searches;
+    }
+
+    uint32_t groups = s->searches;
+    uint32_t unfinished = groups;
+    while (unfinished > 1) {
+        for (uint32_t i = 0; i < s->searches; i++) {
+            if (s->head[i] == s->length[i]) {
+                continue;
+            }
+            uint32_t current = s->queue[i][s->head[i]++];
+            uint32_t next[NEIGHBOURS];
+            neighbours(g, current, next);
+            if (!field_map_reserve(&s->visited, NEIGHBOURS)) {
+                return SEARCH_FAILED;
+            }
+            for (uint32_t j = 0; j < NEIGHBOURS; j++) {
+                if (owner_get(g, next[j]) != player || next[j] == field) {
+                    continue;
+                }
+                uint32_t other;
+                if (!field_map_get(&s->visited, next[j], &other)) {
+                    field_map_set(&s->visited, next[j], i);
+                    if (!search_push(s, i, next[j])) {
+                        return SEARCH_FAILED;
+                    }
+                } else if (search_group(s, other) != search_group(s, i)) {
+                    s->group[search_group(s, other)] = search_group(s, i);
+                    groups--;
+                    if (groups == 1) {
+                        s->keep = search_group(s, i);
+                        return 1;
+                    }
+                }
+            }
+        }
+
+        unfinished = 0;
+        for (uint32_t i = 0; i < s->searches; i++) {
+            if (search_group(s, i) == i && !group_finished(s, i)) {
+                unfinished++;
+                s->keep = i;
+            }
+        }
+    }
+
+    if (unfinished == 0) { // wszystkie części przeszukane, zostawiamy największą
+        for (uint32_t i = 0; i < s->searches; i++) {
+            if (search_group(s, i) == i && group_size(s, i) > group_size(s, s->keep)) {
+                s->keep = i;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < s->searches; i++) {
+        if (search_group(s, i) != s->keep) {
+            s->moved_fields += s->length[i];
+        }
+    }
+    return groups;
+}
+
+/** @brief Odłącza pole od obszaru gracza.
+ * Korzysta z wyniku @ref count_parts dla tego samego pola. Pole dostaje nowy
+ * węzeł, część obszaru, której przeszukiwanie się nie skończyło (lub największa),
+ * zachowuje dotychczasowe drzewo, a pola pozostałych części dostają nowe węzły
+ * podpięte pod nowych reprezentantów. Liczba obszarów gracza jest odpowiednio
+ * poprawiana. Jeśli obszar się nie rozpadł, jego opis jest poprawiany, a w przeciwnym
+ * razie opisy wszystkich części są oznaczane jako nieaktualne i zostaną przeliczone
+ * przy pytaniu o nie. Miejsce na nowe węzły i opisy obszarów musi być wcześniej zapewnione.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, dotychczasowy właściciel pola,
+ * @param[in] field   – indeks pola planszy,
+ * @param[in] parts   – wynik @ref count_parts.
+ */
+static void detach_field(gamma_t *g, uint32_t player, uint32_t field, uint32_t parts) {
+    uint32_t root = field_root(g, field);
+    if (parts == 0) { // pole było samodzielnym obszarem, jego węzeł nie jest nikomu potrzebny
+        region_free(g, root);
+        player_at(g, player)->areas--;
+        return;
+    }
+    region_resize(g, root, root_region(g, root)->size - 1);
+    move_field(g, field);
+
+    split_search *s = &g->search;
+    for (uint32_t group = 0; group < s->searches; group++) {
+        if (search_group(s, group) != group || group == s->keep) {
+            continue;
+        }
+        uint32_t new_root = NO_FIELD;
+        for (uint32_t i = 0; i < s->searches; i++) {
+            if (search_group(s, i) != group) {
+                continue;
+            }
+            for (uint32_t j = 0; j < s->length[i]; j++) {
+                uint32_t node = move_field(g, s->queue[i][j]);
+                if (new_root == NO_FIELD) {
+                    new_root = node;
+                    region_new(g, node, player, s->queue[i][j], group_size(s, group))->stale = true;
+                } else {
+                    set_node(g, node, new_root);
+                }
+            }
+        }
+        region_resize(g, root, root_region(g, root)->size - group_size(s, group));
+    }
+    player_at(g, player)->areas += parts - 1;
+
+    region *kept = region_change(g, root);
+    kept->anchor = s->queue[s->keep][0];
+    uint32_t x, y;
+    field_coordinates(g, field, &x, &y);
+    if (!g->regions_tracked || parts > 1 ||
+        x == kept->min_x || x == kept->max_x || y == kept->min_y || y == kept->max_y) {
+        kept->stale = true;
+        return;
+    }
+    uint32_t neighbour[NEIGHBOURS];
+    neighbours(g, field, neighbour);
+    for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+        if (owner_get(g, neighbour[i]) == NONE && !region_touches(g, player, root, neighbour[i], field)) {
+            kept->frontier--;
+        }
+    }
+}
+
+/** @brief Sprawdza, czy gracz może odebrać pole złotym ruchem.
+ * Nie sprawdza, czy gracz wykonał już złoty ruch.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] field   – indeks pola planszy,
+ * @param[out] parts  – wynik @ref count_parts dla właściciela pola, zero, jeśli
+ *                      do przeszukiwania nie doszło.
+ * @return Wartość @p true, jeśli ruch jest zgodny z zasadami gry, a @p false,
+ * gdy nie jest lub zabrakło pamięci (wtedy @p parts to SEARCH_FAILED).
+ */
+static bool golden_move_allowed(gamma_t *g, uint32_t player, uint32_t field, uint32_t *parts) {
+    *parts = 0;
+    uint32_t victim = owner_get(g, field);
+    if (victim == NONE || victim == player) {
+        return false;
+    }
+    if (owner_fields_neighbouring(g, player, field) == 0 &&
+        player_info(g, player)->areas >= g->max_areas) {
+        return false;
+    }
+
+    // sprawdzamy, czy obszar ofiary nie rozpadnie się na zbyt wiele części
+    *parts = count_parts(g, victim, field);
+    if (*parts == SEARCH_FAILED) {
+        return false;
+    }
+    return *parts <= 1 || player_at(g, victim)->areas + (uint64_t)*parts - 1 <= g->max_areas;
+}
+
+bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (!valid_player(g, player) || x >= g->width || y >= g->height) {
+        return false;
+    }
+    if (player_info(g, player)->golden_unused == false) {
+        return false;
+    }
+    uint32_t field = board_cell(g, x, y);
+    uint32_t parts;
+    if (field == NO_FIELD || !golden_move_allowed(g, player, field, &parts)) {
+        return false;
+    }
+    uint32_t victim = owner_get(g, field);
+    if (!reserve_regions(g, NEIGHBOURS) || !reserve_spare_nodes(g, g->search.moved_fields + 1) ||
+        !reserve_golden_index(g) || player_table_touch(&g->players, player) == NULL ||
+        !reserve_journal(g, g->search.moved_fields + 1) || !reserve_frontiers(g, player, field)) {
+        return false;
+    }
+
+    journal_begin(g, player, x, y, field);
+    frontier_view view;
+    frontier_view_read(g, field, &view);
+    player_at(g, player)->free_fields += new_free_fields(g, player, field);
+    player_at(g, player)->busy_fields++;
+
+    set_owner(g, field, player);
+    detach_field(g, victim, field, parts);
+
+    player_at(g, victim)->free_fields -= new_free_fields(g, victim, field);
+    player_at(g, victim)->busy_fields--;
+
+    attach_field(g, player, field);
+
+    hash_field(g, x, y, victim);
+    hash_field(g, x, y, player);
+    use_golden_move(g, player);
+    frontier_view_update(g, &view);
+    return true;
+}
+
+bool gamma_undo(gamma_t *g) {
+    if (g == NULL || !g->journal.enabled || g->journal.move_count == 0) {
+        return false;
+    }
+    move_journal *journal = &g->journal;
+    journal_move *move = &journal->moves[journal->move_count - 1];
+    // zbiory graczy nie są zapisywane w dzienniku, tylko poprawiane po przywróceniu pól,
+    // a zmiana może dotyczyć tylko graczy, których opisy zapamiętał ruch
+    for (uint64_t i = move->player_start; g->frontiers_tracked && i < journal->player_count; i++) {
+        uint32_t number = journal->players[i].number;
+        if (!frontier_table_reserve(&g->frontiers, number, NEIGHBOURS) ||
+            !frontier_table_reserve(&g->contacts, number, NEIGHBOURS + 1)) {
+            return false;
+        }
+    }
+    journal->move_count--;
+    frontier_view view;
+    frontier_view_read(g, move->field, &view);
+    while (journal->entry_count > move->entry_start) {
+        journal_entry *entry = &journal->entries[--journal->entry_count];
+        if (entry->kind == JOURNAL_OWNER) {
+            bits_set_owner(g, entry->index, entry->value);
+            owner_set(g, entry->index, entry->value);
+        } else if (entry->kind == JOURNAL_NODE) {
+            *node_slot(g, entry->index) = entry->value;
+        } else if (entry->kind == JOURNAL_RISKY) {
+            g->risky_fields[entry->index] = entry->value;
+        } else {
+            field_map *map = entry->kind == JOURNAL_MOVED ? &g->moved : &g->risky_position;
+            if (entry->value == JOURNAL_ABSENT) {
+                field_map_remove(map, entry->index);
+            } else {
+                field_map_set(map, entry->index, entry->value);
+            }
+        }
+    }
+    while (journal->region_count > move->region_start) {
+        journal_region *saved = &journal->regions[--journal->region_count];
+        g->regions[saved->id] = saved->record;
+    }
+    while (journal->player_count > move->player_start) {
+        journal_player *saved = &journal->players[--journal->player_count];
+        *player_at(g, saved->number) = saved->record;
+    }
+    g->busy_count = move->busy_count;
+    g->hash = move->hash;
+    g->spare_count = move->spare_count;
+    g->region_count = move->region_count;
+    g->free_region = move->free_region;
+    g->risky_count = move->risky_count;
+    frontier_view_update(g, &view);
+    return true;
+}
+
+/** @brief Dopisuje współrzędne pola do wyniku, jeśli jest na nie miejsce.
+ */
+static inline void append_position(field_position *out, uint64_t capacity, uint64_t count,
+                                   uint32_t x, uint32_t y) {
+    if (count < capacity) {
+        out[count].x = x;
+        out[count].y = y;
+    }
+}
+
+/** @brief Dopisuje do wyniku współrzędne pól z wierszy planszy bitowej, wierszami.
+ * @param[in] rows     – wiersze zbioru pól,
+ * @param[in] height   – liczba wierszy,
+ * @param[out] out     – tablica na współrzędne pól,
+ * @param[in] capacity – rozmiar tablicy @p out.
+ */
+static void append_row_positions(const uint64_t *rows, uint32_t height, field_position *out, uint64_t capacity) {
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < height && count < capacity; y++) {
+        for (uint64_t row = rows[y]; row != 0 && count < capacity; row &= row - 1) {
+            append_position(out, capacity, count++, __builtin_ctzll(row), y);
+        }
+    }
+}
+
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player, field_position *out, uint64_t capacity) {
+    if (!valid_player(g, player)) {
+        return 0;
+    }
+    uint64_t rows[BITBOARD_SIDE];
+    if (player_info(g, player)->areas < g->max_areas) {
+        uint64_t total = (uint64_t)g->width * g->height - g->busy_count;
+        if (g->bits != NULL) {
+            for (uint32_t y = 0; y < g->height; y++) {
+                rows[y] = ~g->bits->occupied.rows[y + 1] & g->bits->row_mask;
+            }
+            append_row_positions(rows, g->height, out, capacity);
+            return total;
+        }
+        uint64_t count = 0;
+        for (uint32_t y = 0; y < g->height && count < capacity && count < total; y++) {
+            for (uint32_t x = 0; x < g->width && count < capacity; x++) {
+                if (owner_at(g, x, y) == NONE) {
+                    append_position(out, capacity, count++, x, y);
+                }
+            }
+        }
+        return total;
+    }
+
+    if (g->bits != NULL) {
+        uint64_t total = bitboard_frontier(g->bits, player, rows);
+        assert(total == player_info(g, player)->free_fields);
+        append_row_positions(rows, g->height, out, capacity);
+        return total;
+    }
+    if (!track_frontiers(g)) {
+        return 0;
+    }
+    const frontier *f = frontier_table_get(&g->frontiers, player);
+    uint64_t total = f == NULL ? 0 : f->count;
+    assert(total == player_info(g, player)->free_fields);
+    for (uint64_t i = 0; i < total && i < capacity; i++) {
+        field_coordinates(g, f->fields[i], &out[i].x, &out[i].y);
+    }
+    return total;
+}
+
+uint64_t gamma_golden_legal_moves(gamma_t *g, uint32_t player, field_position *out, uint64_t capacity) {
+    if (!valid_player(g, player) || !player_info(g, player)->golden_unused) {
+        return 0;
+    }
+    uint64_t count = 0;
+    uint32_t parts, x, y;
+    if (player_info(g, player)->areas < g->max_areas) {
+        // pola planszy z kafelkami są tylko w utworzonych kafelkach, więc wystarczy przejrzeć tablice
+        for (uint32_t field = 0; field < g->cell_count; field++) {
+            uint32_t owner = owner_get(g, field);
+            if (owner == NONE || owner == BORDER || owner == player) {
+                continue;
             }
-            free(g->board);
-            free(g);
-            return NULL;
+            if (!golden_move_allowed(g, player, field, &parts)) {
+                if (parts == SEARCH_FAILED) {
+                    return 0;
+                }
+                continue;
+            }
+            field_coordinates(g, field, &x, &y);
+            append_position(out, capacity, count++, x, y);
         }
+        return count;
     }
 
-    for (uint32_t i = 0; i < width; i++) {
-        for (uint32_t j = 0; j < height; j++) {
-            g->board[i][j].owner = NONE;
-            g->board[i][j].root = &g->board[i][j];
+    if (g->bits != NULL) {
+        uint64_t rows[BITBOARD_SIDE];
+        bitboard_contacts(g->bits, player, rows);
+        for (y = 0; y < g->height; y++) {
+            for (uint64_t row = rows[y]; row != 0; row &= row - 1) {
+                x = __builtin_ctzll(row);
+                if (!golden_move_allowed(g, player, board_cell(g, x, y), &parts)) {
+                    if (parts == SEARCH_FAILED) {
+                        return 0;
+                    }
+                    continue;
+                }
+                append_position(out, capacity, count++, x, y);
+            }
         }
+        return count;
     }
-
-    return g;
-}
-
-void gamma_delete(gamma_t *g) {
-    if (g != NULL) {
-        free(g->players);
-        for (uint32_t i = 0; i < g->width; i++) {
-            free(g->board[i]);
+    if (!track_frontiers(g)) {
+        return 0;
+    }
+    const frontier *f = frontier_table_get(&g->contacts, player);
+    for (uint32_t i = 0; f != NULL && i < f->count; i++) {
+        uint32_t field = f->fields[i];
+        if (!golden_move_allowed(g, player, field, &parts)) {
+            if (parts == SEARCH_FAILED) {
+                return 0;
+            }
+            continue;
         }
-        free(g->board);
-        free(g);
+        field_coordinates(g, field, &x, &y);
+        append_position(out, capacity, count++, x, y);
     }
+    return count;
 }
 
-/** @brief Podaje ilość pól należacych do danego gracza sąsiadujących z danym polem.
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
- */
-static uint32_t owner_fields_neighbouring(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    uint32_t owner_fields_neighbouring = 0;
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player)
-                owner_fields_neighbouring++;
-        }
-    }
-    return owner_fields_neighbouring;
+uint64_t gamma_hash(gamma_t *g) {
+    return g == NULL ? 0 : g->hash;
 }
 
-/** @brief Znajduje reprezentanta obszaru do którego należy pole.
- * Funkcja znajduje rekurencyjnie reprezentanta obszaru do którego należy dane pole,
- * kompresując również ścieżkę wskaźników do reprezentanta.
- */
-static field *find_root(field *a) {
-    assert(a != NULL);
-    if (a->root != a) {
-        a->root = find_root(a->root);
+uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
+    if (!valid_player(g, player)) {
+        return 0;
     }
-    return a->root;
+    return player_info(g, player)->busy_fields;
 }
 
-/** @brief Dołącza pole do obszaru.
- * Funkcja ustawia root danego pola na reprezentanta
- * obszaru do którego pole jest przyłączane.
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
+#ifndef NDEBUG
+/** @brief Sprawdza licznik zajętych pól, przeliczając go na nowo z planszy.
+ * Używana tylko w wersji diagnostycznej.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli licznik jest poprawny, a @p false wpp.
  */
-static void unite_single(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player)
-                g->board[x][y].root = find_root(&g->board[x + change[i]][y + change[3 - i]]);
-        }
+static bool busy_count_consistent(gamma_t *g) {
+    if (g->bits != NULL) {
+        return bitboard_count(g->bits, &g->bits->occupied) == g->busy_count;
     }
+    uint64_t busy_count = 0;
+    for (uint32_t field = 0; field < g->cell_count; field++) {
+        if (owner_get(g, field) != NONE && owner_get(g, field) != BORDER)
+            busy_count++;
+    }
+    return busy_count == g->busy_count;
 }
+#endif
 
-/** @brief Dołącza pole do obszaru, łączy obszary.
- * Funkcja ustawia root danego pola na reprezentanta
- * jednego z obszarów gracza z którymi sąsiaduje.
- *
- * W wypadku, w którym nowo zajęte pole
- * sąsiaduje z rozłącznymi obszarami gracza łączy je,
- * zmiejszając parametr areas gracza i ustawiając root
- * reprezentantów obszarów na reprezentanta
- * jednego z obszarów.
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
- */
-static void unite_multiple(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player) {
-                g->board[x][y].root = find_root(&g->board[x + change[i]][y + change[3 - i]]);
-                break;
-            }
-        }
-    }
-
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player) {
-                field *root = find_root(&g->board[x + change[i]][y + change[3 - i]]);
-                if (root != g->board[x][y].root) {
-                    g->players[player - 1].areas--;
-                    root->root = g->board[x][y].root;
-                }
-            }
-        }
+uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
+    if (!valid_player(g, player)) {
+        return 0;
+    }
+    assert(busy_count_consistent(g));
+    if (player_info(g, player)->areas < g->max_areas) {
+        return (uint64_t)g->width * g->height - g->busy_count;
+    } else {
+        return player_info(g, player)->free_fields;
     }
 }
 
-/** @brief Podaje liczbe nowych sąsiednich wolnych pól.
- * Funkcja podaje liczbę pól sąsiadujących z nim, które są
- * niezajęte i nie sąsiadują z żadnym polem zajętym przez danego gracza.
+/** @brief Sprawdza, czy ryzykowne pole może być celem złotego ruchu.
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
- * @return liczba nowych sąsiednich wolnych pól
+ * @param[in] field   – indeks pola zajętego przez ofiarę.
+ * @return Wartość @p true, jeśli odebranie pola nie przekroczy limitu obszarów
+ * ofiary, a @p false wpp.
  */
-static uint64_t new_free_fields(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    uint64_t new_free_fields = 0;
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == NONE)
-                if (owner_fields_neighbouring(g, player, x + change[i], y + change[3 - i]) == 0)
-                    new_free_fields++;
-        }
+static bool risky_target_allowed(gamma_t *g, uint32_t field) {
+    uint32_t victim = owner_get(g, field);
+    uint32_t victim_areas_under_limit = g->max_areas - player_info(g, victim)->areas;
+    if (victim_areas_under_limit >= 2) { // w tej sytuacji ofiarze przybędą maksymalnie dwa nowe obszary
+        return true;
     }
-
-    return new_free_fields;
+    uint32_t parts = count_parts(g, victim, field);
+    return parts != SEARCH_FAILED && parts <= victim_areas_under_limit + 1;
 }
 
-/** @brief Ustawia pole jako zajęte
- * Funkcja sprawia, że dany gracz staje się właścicielem danego pola,
- * jego liczba zajętych pól zwiększa się o jeden, a liczba sąsiednich wolnych pól
- * innych graczy, którzy sąsiadują z tym polem zmniejsza się o jeden.
+/** @brief Sprawdza, czy gracz będący na limicie obszarów ma cel złotego ruchu.
+ * Bezpieczny cel sąsiadujący z polami gracza wystarcza. W przeciwnym razie
+ * sprawdzane są tylko pola innych graczy sąsiadujące z polami gracza, wzięte
+ * z planszy bitowej lub ze zbioru gracza.
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
- */
-static void make_field_busy(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    g->board[x][y].owner = player;
-    g->players[player - 1].busy_fields++;
-    uint32_t owner[4] = {NONE, NONE, NONE, NONE};
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-
-            if (g->board[x + change[i]][y + change[3 - i]].owner != player &&
-                g->board[x + change[i]][y + change[3 - i]].owner != NONE) {
-                owner[i] = g->board[x + change[i]][y + change[3 - i]].owner;
-                bool unique = true;
-                /*
-                 * nie zabieramy wolnego pola danemu graczowi
-                 * więcej niż raz
-                 */
-                for (uint32_t j = 0; j < i; j++) {
-                    if (owner[i] == owner[j])
-                        unique = false;
+ *                      @p players z funkcji @ref gamma_new.
+ * @return Wartość @p true, jeśli istnieje cel złotego ruchu, a @p false wpp.
+ */
+bool golden_target_avalible(gamma_t *g, uint32_t player) {
+    if (player_info(g, player)->safe_golden_targets > 0) {
+        return true;
+    }
+    if (player_info(g, player)->golden_targets == 0) {
+        return false;
+    }
+
+    // bez bezpiecznych celów wszystkie pola sąsiadujące z polami gracza są ryzykowne
+    if (g->bits != NULL) {
+        uint64_t rows[BITBOARD_SIDE];
+        bitboard_contacts(g->bits, player, rows);
+        for (uint32_t y = 0; y < g->height; y++) {
+            for (uint64_t row = rows[y]; row != 0; row &= row - 1) {
+                if (risky_target_allowed(g, board_cell(g, __builtin_ctzll(row), y))) {
+                    return true;
                 }
-                if (unique)
-                    g->players[owner[i] - 1].free_fields--;
             }
         }
-    }
-}
-
-bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if (player < 1 || player > g->player_count || x >= g->width || y >= g->height) {
         return false;
     }
-    if (g->board[x][y].owner != NONE) {
+    if (track_frontiers(g)) {
+        const frontier *f = frontier_table_get(&g->contacts, player);
+        for (uint32_t i = 0; f != NULL && i < f->count; i++) {
+            if (risky_target_allowed(g, f->fields[i])) {
+                return true;
+            }
+        }
         return false;
     }
-    int own_fields_neighbouring = owner_fields_neighbouring(g, player, x, y);
-    if (own_fields_neighbouring > 0) {
-        g->players[player - 1].free_fields += new_free_fields(g, player, x, y) - 1;
-        make_field_busy(g, player, x, y);
-        if (own_fields_neighbouring == 1)
-            unite_single(g, player, x, y);
-        else
-            unite_multiple(g, player, x, y);
-    } else {
-        if (g->players[player - 1].areas >= g->max_areas) {
-            return false;
-        } else {
-            g->players[player - 1].areas++;
-            g->players[player - 1].free_fields += new_free_fields(g, player, x, y);
-            make_field_busy(g, player, x, y);
 
-            //pole staje się reprezentanem nowego obszaru
-            g->board[x][y].root = &g->board[x][y];
+    // bez pamięci na zbiory graczy zostają wszystkie pola ryzykowne
+    for (uint32_t i = 0; i < g->risky_count; i++) {
+        uint32_t field = g->risky_fields[i];
+        if (owner_get(g, field) != player && owner_fields_neighbouring(g, player, field) > 0 &&
+            risky_target_allowed(g, field)) {
+            return true;
         }
     }
-    return true;
+    return false;
 }
 
-/** @brief Podaje liczbę nowo powstałych obszarów
- * Funkcja podaje liczbe nowych obszarów, które moga powstać
- * na skutek złotego ruchu innego gracza, dzielącego obszar gracza
- * na 1-4 części (czyli 0-3 nowe).
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
- * @return liczba nowo powstałych obszarów
- */
-static uint32_t separated_areas(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    uint32_t separated_areas = 0;
-    field *root[4] = {NULL, NULL, NULL, NULL};
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player) {
-                root[i] = g->board[x + change[i]][y + change[3 - i]].root;
-            }
-        }
+bool gamma_golden_possible(gamma_t *g, uint32_t player) {
+    if (!valid_player(g, player) || player_info(g, player)->golden_unused == false) {
+        return false;
     }
-
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3 - i; j++) {
-            if (root[j] > root[j + 1]) {
-                swap(&root[j], &root[j + 1]);
-            }
-        }
+    bool other_players_have_fields = g->busy_count > player_info(g, player)->busy_fields;
+    if (!other_players_have_fields) {
+        return false;
     }
-
-    for (int i = 1; i < 4; i++) {
-        if (root[i] && root[i - 1] && root[i] != root[i - 1])
-            separated_areas++;
+    if (player_info(g, player)->areas < g->max_areas) {
+        return true;
     }
 
-    return separated_areas;
+    return golden_target_avalible(g, player);
 }
 
-/** @brief Funkcja pomocnicza do update_roots
- * Rekurencyjnie przechodzi osiągalne pola gracza
- * ustawiając ich reprezentanta na sąsiada
- * pola przekazanego do update_roots, z którym funkcja
- * set_accessible_root została wywowałana
+/** @brief Przelicza prostokąt i liczbę wolnych sąsiadów obszaru.
+ * Przeszukuje wszerz pola obszaru od pola @p anchor, korzystając z pamięci
+ * pomocniczej @p g->search, którą inaczej zajmuje tylko złoty ruch.
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
+ * @param[in,out] r   – wskaźnik na opis obszaru.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
  */
-static void set_accessible_root(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    field *new_root = g->board[x][y].root;
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player &&
-                g->board[x + change[i]][y + change[3 - i]].root != new_root) {
-
-                g->board[x + change[i]][y + change[3 - i]].root = new_root;
-                set_accessible_root(g, player, x + change[i], y + change[3 - i]);
-
+static bool region_measure(gamma_t *g, region *r) {
+    split_search *s = &g->search;
+    field_map_clear(&s->visited);
+    s->searches = 0;
+    s->length[0] = 0;
+    if (!field_map_reserve(&s->visited, 1) || !search_push(s, 0, r->anchor)) {
+        return false;
+    }
+    field_map_set(&s->visited, r->anchor, 0);
+    region measured = *r;
+    field_coordinates(g, r->anchor, &measured.min_x, &measured.min_y);
+    measured.max_x = measured.min_x;
+    measured.max_y = measured.min_y;
+    measured.frontier = 0;
+    for (uint32_t head = 0; head < s->length[0]; head++) {
+        uint32_t current = s->queue[0][head];
+        region_extend(g, &measured, current);
+        uint32_t neighbour[NEIGHBOURS];
+        neighbours(g, current, neighbour);
+        if (!field_map_reserve(&s->visited, NEIGHBOURS)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < NEIGHBOURS; i++) {
+            uint32_t owner = owner_get(g, neighbour[i]);
+            if ((owner != NONE && owner != r->owner) || field_map_get(&s->visited, neighbour[i], NULL)) {
+                continue;
+            }
+            field_map_set(&s->visited, neighbour[i], 0);
+            if (owner == NONE) {
+                measured.frontier++;
+            } else if (!search_push(s, 0, neighbour[i])) {
+                return false;
             }
         }
     }
+    measured.stale = false;
+    *r = measured;
+    return true;
 }
 
-/** @brief Uaktualnia reprezantantów obszarów
- * Funkcja ustawia swoim sasiadom reprezentantów, którzy
- * na pewno są osiągalni. Jest to konieczne, bo przy złotym
- * ruchu może dojść do rozdzielenia obszarów i część pól
- * może wskazywać na nieosiągalnego reprezentanta.
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
- *                      @p players z funkcji @ref gamma_new,
- * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
- *                      @p width z funkcji @ref gamma_new,
- * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
- *                      @p height z funkcji @ref gamma_new.
+/** @brief Przepisuje opis obszaru do postaci udostępnianej na zewnątrz.
+ * Nieaktualny opis jest najpierw przeliczany. Od pierwszego wywołania ruchy
+ * poprawiają opisy obszarów.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
  */
-static void update_roots(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    int change[4] = {-1, 0, 1, 0};
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-            (int64_t) y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player) {
-                g->board[x + change[i]][y + change[3 - i]].root = NULL;
-            }
-        }
-    }
-
-    for (uint32_t i = 0; i < 4; i++) {
-        if ((int64_t)x + change[i] >= 0 && (int64_t)x + change[i] < g->width &&
-        (int64_t)y + change[3 - i] >= 0 && (int64_t)y + change[3 - i] < g->height) {
-            if (g->board[x + change[i]][y + change[3 - i]].owner == player &&
-                g->board[x + change[i]][y + change[3 - i]].root == NULL) {
-                g->board[x + change[i]][y + change[3 - i]].root = &g->board[x + change[i]][y + change[3 - i]];
-                set_accessible_root(g, player, x + change[i], y + change[3 - i]);
-            }
-        }
+static bool describe_region(gamma_t *g, region *r, region_info *info) {
+    g->regions_tracked = true;
+    if (r->stale && !region_measure(g, r)) {
+        return false;
     }
+    info->player = r->owner;
+    info->size = r->size;
+    info->min_x = r->min_x;
+    info->min_y = r->min_y;
+    info->max_x = r->max_x;
+    info->max_y = r->max_y;
+    info->frontier = r->frontier;
+    return true;
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if (g->players[player - 1].golden_unused == false) {
+bool gamma_region_info(gamma_t *g, uint32_t x, uint32_t y, region_info *info) {
+    if (g == NULL || info == NULL || x >= g->width || y >= g->height) {
         return false;
     }
-    if (player < 1 || player > g->player_count || x >= g->width || y >= g->height) {
+    uint32_t field = board_cell(g, x, y);
+    if (field == NO_FIELD || owner_get(g, field) == NONE) {
         return false;
     }
-    if (g->board[x][y].owner == NONE || g->board[x][y].owner == player) {
-        return false;
+    return describe_region(g, root_region(g, field_root(g, field)), info);
+}
+
+uint64_t gamma_player_regions(gamma_t *g, uint32_t player, region_info *out, uint64_t capacity) {
+    if (!valid_player(g, player)) {
+        return 0;
     }
-    uint32_t victim = g->board[x][y].owner;
-    int own_fields_neighbouring = owner_fields_neighbouring(g, player, x, y);
-    int victims_fields_neighbouring = owner_fields_neighbouring(g, victim, x, y);
+    uint64_t areas = player_info(g, player)->areas;
+    uint64_t count = 0;
+    for (uint32_t id = 0; id < g->region_count && count < areas; id++) {
+        region *r = &g->regions[id];
+        if (r->owner != player) {
+            continue;
+        }
+        if (count < capacity && !describe_region(g, r, &out[count])) {
+            return 0;
+        }
+        count++;
+    }
+    return count;
+}
 
-    if (own_fields_neighbouring > 0) {
-        g->players[player - 1].free_fields += new_free_fields(g, player, x, y);
-        g->players[player - 1].busy_fields++;
+/**
+ * Rozmiar bufora, w którym składane są fragmenty opisu planszy
+ */
+#define BOARD_CHUNK 4096
 
-        g->board[x][y].owner = player;
+/**
+ * Najdłuższy opis jednego pola planszy
+ */
+#define FIELD_TEXT 4
 
-        g->players[victim - 1].free_fields -= new_free_fields(g, victim, x, y);
-        g->players[victim - 1].busy_fields--;
+/** @brief Bufor, w którym składany jest opis planszy.
+ */
+typedef struct {
+    char data[BOARD_CHUNK]; ///< złożona część opisu
+    size_t length;          ///< długość złożonej części
+    board_sink sink;        ///< funkcja odbierająca gotowe fragmenty
+    void *context;          ///< wskaźnik przekazywany funkcji @p sink
+} board_text;
 
+/** @brief Przekazuje złożoną część opisu planszy dalej.
+ */
+static void board_text_flush(board_text *text) {
+    if (text->length > 0) {
+        text->sink(text->data, text->length, text->context);
+        text->length = 0;
+    }
+}
 
-        if (own_fields_neighbouring == 1)
-            unite_single(g, player, x, y);
-        else
-            unite_multiple(g, player, x, y);
+/** @brief Dopisuje do opisu planszy opis pola o danym właścicielu.
+ * Przy co najmniej dziesięciu graczach właściciel o numerze od 10 zajmuje
+ * cztery znaki w nawiasach kwadratowych.
+ */
+static inline void board_text_field(board_text *text, gamma_t *g, uint32_t owner) {
+    if (text->length + FIELD_TEXT > BOARD_CHUNK) {
+        board_text_flush(text);
+    }
+    if (owner == NONE) {
+        text->data[text->length++] = '.';
+    } else if (g->player_count < 10 || owner < 10) {
+        text->data[text->length++] = owner + '0';
     } else {
-        if (g->players[player - 1].areas >= g->max_areas) {
-            return false;
-        } else {
-            g->players[player - 1].areas++;
-            g->players[player - 1].free_fields += new_free_fields(g, player, x, y);
-            g->players[player - 1].busy_fields++;
-
-            g->board[x][y].owner = player;
-
-            g->players[victim - 1].free_fields -= new_free_fields(g, victim, x, y);
-            g->players[victim - 1].busy_fields--;
-
-            //pole staje się reprezentanem nowego obszaru
-            g->board[x][y].root = &g->board[x][y];
-        }
+        uint32_t first_digit = owner / 10;
+        text->data[text->length++] = '[';
+        text->data[text->length++] = first_digit + '0';
+        text->data[text->length++] = owner - first_digit * 10 + '0';
+        text->data[text->length++] = ']';
     }
+}
 
-    if (victims_fields_neighbouring == 0) {
-        g->players[victim - 1].areas--;
-    } else if (victims_fields_neighbouring > 1) {
-        update_roots(g, victim, x, y);
-        int new_areas = separated_areas(g, victim, x, y);
-
-        if (new_areas > 0) {
-            g->players[victim - 1].areas += new_areas;
-            if (g->players[victim - 1].areas > g->max_areas) {
-                // cofamy ruch
-                if (own_fields_neighbouring == 0) {
-                    g->players[player - 1].areas--;
-                }
-                g->players[player - 1].busy_fields--;
-
-                g->players[victim - 1].free_fields += new_free_fields(g, victim, x, y);
-                g->players[victim - 1].busy_fields++;
-                g->board[x][y].owner = victim;
+/** @brief Sprawdza, czy prostokąt leży w całości na planszy.
+ */
+static bool valid_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height) {
+    return g != NULL && width > 0 && height > 0 &&
+           (uint64_t)x0 + width <= g->width && (uint64_t)y0 + height <= g->height;
+}
 
-                g->players[player - 1].free_fields -= new_free_fields(g, player, x, y);
-                unite_multiple(g, victim, x, y);
-                return false;
+bool gamma_board_region_write(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height,
+                              board_sink sink, void *context) {
+    if (!valid_region(g, x0, y0, width, height) || sink == NULL) {
+        return false;
+    }
+    board_text text;
+    text.length = 0;
+    text.sink = sink;
+    text.context = context;
+    for (uint32_t y = y0 + height; y-- > y0;) {
+        // kolejne pola wiersza leżą obok siebie w całym wierszu lub w wierszu kafelka
+        uint32_t x = x0;
+        while (x - x0 < width) {
+            uint32_t run = width - (x - x0);
+            if (g->tiled && run > TILE_SIDE - (x & (TILE_SIDE - 1))) {
+                run = TILE_SIDE - (x & (TILE_SIDE - 1));
+            }
+            uint32_t field = board_cell(g, x, y);
+            for (uint32_t i = 0; i < run; i++) {
+                board_text_field(&text, g, field == NO_FIELD ? NONE : owner_get(g, field + i));
             }
+            x += run;
         }
+        if (text.length == BOARD_CHUNK) {
+            board_text_flush(&text);
+        }
+        text.data[text.length++] = '\n';
     }
-
-    g->players[player - 1].golden_unused = false;
+    board_text_flush(&text);
     return true;
 }
 
-
-uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
-    if (player > g->player_count) {
-        return 0;
+bool gamma_board_write(gamma_t *g, board_sink sink, void *context) {
+    if (g == NULL) {
+        return false;
     }
-    return g->players[player - 1].busy_fields;
+    return gamma_board_region_write(g, 0, 0, g->width, g->height, sink, context);
 }
 
-uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
-    if (player > g->player_count) {
-        return 0;
+/** @brief Napis budowany przez @ref gamma_board.
+ */
+typedef struct {
+    char *data;      ///< zawartość napisu
+    size_t length;   ///< długość napisu
+    size_t capacity; ///< rozmiar tablicy @p data
+    bool failed;     ///< true, jeśli zabrakło pamięci
+} board_string;
+
+/** @brief Dopisuje fragment opisu planszy do napisu, powiększając go w razie potrzeby.
+ */
+static void board_string_append(const char *data, size_t length, void *context) {
+    board_string *string = context;
+    if (string->failed) {
+        return;
     }
-    if (g->players[player - 1].areas < g->max_areas) {
-        uint64_t free_fields = (uint64_t)g->width * g->height;
-        for (uint32_t i = 0; i < g->player_count; i++) {
-            free_fields -= g->players[i].busy_fields;
+    if (string->length + length + 1 > string->capacity) {
+        size_t capacity = 2 * string->capacity;
+        if (capacity < string->length + length + 1) {
+            capacity = string->length + length + 1;
         }
-        return (free_fields);
-    } else {
-        return g->players[player - 1].free_fields;
+        char *grown = realloc(string->data, capacity);
+        if (grown == NULL) {
+            string->failed = true;
+            return;
+        }
+        string->data = grown;
+        string->capacity = capacity;
     }
+    for (size_t i = 0; i < length; i++) {
+        string->data[string->length + i] = data[i];
+    }
+    string->length += length;
 }
 
-bool golden_target_avalible(gamma_t *g, uint32_t player) {
+char *gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height) {
+    if (!valid_region(g, x0, y0, width, height)) {
+        return NULL;
+    }
+    // przy mniej niż dziesięciu graczach każde pole to jeden znak, więc rozmiar jest dokładny
+    board_string string;
+    string.capacity = 1 + ((uint64_t)width + 1) * height;
+    string.data = malloc(string.capacity);
+    string.length = 0;
+    string.failed = string.data == NULL;
+    gamma_board_region_write(g, x0, y0, width, height, board_string_append, &string);
+    if (string.failed) {
+        free(string.data);
+        return NULL;
+    }
+    string.data[string.length] = '\0';
+    return string.data;
+}
 
-    for (uint32_t x = 0; x < g->width; x++) {
-        for (uint32_t y = 0; y < g->height; y++) {
+char *gamma_board(gamma_t *g) {
+    if (g == NULL) {
+        return NULL;
+    }
+    return gamma_board_region(g, 0, 0, g->width, g->height);
+}
 
-            field current_field = g->board[x][y];
-            if (current_field.owner != player && current_field.owner != NONE) {
-                if (owner_fields_neighbouring(g, player, x, y) > 0) {
+/**
+ * Napis rozpoczynający plik ze stanem gry
+ */
+#define SNAPSHOT_MAGIC "GAMMASAV"
 
-                    uint32_t victim_areas_under_limit = g->max_areas - g->players[current_field.owner - 1].areas;
-                    if (victim_areas_under_limit >= 2) {// w tej sytuacji ofiarze przybędą maksymalnie dwa nowe obszary
-                        return true;
-                    }
-                    uint32_t victim = current_field.owner;
-                    current_field.owner = player;
-                    update_roots(g, victim, x, y);
-                    uint32_t new_areas = separated_areas(g, victim, x ,y);
-                    current_field.owner = victim;
+/**
+ * Liczba zajętych pól zapisywanych naraz
+ */
+#define SNAPSHOT_CHUNK 1024
 
-                    if (new_areas <= victim_areas_under_limit)
-                        return true;
+/** @brief Nagłówek pliku ze stanem gry.
+ * Po nagłówku leżą numery graczy, którzy wykonali już złoty ruch,
+ * a po nich opisy wszystkich zajętych pól.
+ */
+typedef struct {
+    char magic[8];         ///< napis "GAMMASAV" bez znaku końca
+    uint32_t version;      ///< wersja formatu, @ref GAMMA_SNAPSHOT_VERSION
+    uint32_t width;        ///< szerokość planszy
+    uint32_t height;       ///< wysokość planszy
+    uint32_t players;      ///< liczba graczy
+    uint32_t areas;        ///< maksymalna liczba obszarów gracza
+    uint32_t reserved;     ///< zero, wyrównuje następne pola
+    uint64_t golden_used;  ///< liczba graczy, którzy wykonali złoty ruch
+    uint64_t busy_fields;  ///< liczba zajętych pól
+} snapshot_header;
 
-                }
-            }
+/** @brief Opis zajętego pola w pliku ze stanem gry.
+ */
+typedef struct {
+    uint32_t x;     ///< numer kolumny
+    uint32_t y;     ///< numer wiersza
+    uint32_t owner; ///< właściciel pola
+} snapshot_field;
 
-        }
-    }
+/** @brief Bufor opisów zajętych pól zapisywanych do pliku.
+ */
+typedef struct {
+    snapshot_field fields[SNAPSHOT_CHUNK]; ///< opisy pól czekające na zapis
+    uint32_t length;                       ///< liczba opisów w buforze
+    FILE *file;                            ///< plik ze stanem gry
+} snapshot_writer;
 
-    return false;
+/** @brief Dopisuje opis zajętego pola, zapisując pełny bufor do pliku.
+ */
+static void snapshot_write_field(snapshot_writer *writer, uint32_t x, uint32_t y, uint32_t owner) {
+    if (writer->length == SNAPSHOT_CHUNK) {
+        fwrite(writer->fields, sizeof(snapshot_field), writer->length, writer->file);
+        writer->length = 0;
+    }
+    snapshot_field *field = &writer->fields[writer->length++];
+    field->x = x;
+    field->y = y;
+    field->owner = owner;
 }
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player) {
-    if (player > g->player_count || g->players[player - 1].golden_unused == false) {
+bool gamma_save(gamma_t *g, const char *path) {
+    if (g == NULL || path == NULL) {
         return false;
     }
-    bool other_players_have_fields = false;
-    for (uint32_t i = 0; i < g->player_count; i++) {
-        if (i != player - 1 && g->players[i].busy_fields > 0) {
-            other_players_have_fields = true;
-            break;
-        }
-    }
-    if (!other_players_have_fields) {
+    snapshot_writer *writer = malloc(sizeof(*writer));
+    if (writer == NULL) {
         return false;
     }
-    if (g->players[player - 1].areas < g->max_areas) {
-        return true;
+    writer->length = 0;
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        free(writer);
+        return false;
     }
 
-    return golden_target_avalible(g, player);
-}
-
-char *gamma_board(gamma_t *g) {
-    if (g == NULL) {
-        return NULL;
+    snapshot_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = GAMMA_SNAPSHOT_VERSION;
+    header.width = g->width;
+    header.height = g->height;
+    header.players = g->player_count;
+    header.areas = g->max_areas;
+    header.busy_fields = g->busy_count;
+    // złoty ruch mogli wykonać tylko gracze z utworzonym opisem
+    for (uint32_t number = player_table_next(&g->players, 1); number != 0;
+         number = player_table_next(&g->players, number + 1)) {
+        header.golden_used += !player_info(g, number)->golden_unused;
     }
-    char *board = NULL;
-    if (g->player_count < 10) {
-        board = malloc(1 + (uint64_t)(g->width + 1) * g->height * sizeof(char));
-        if (board == NULL) {
-            return NULL;
+    fwrite(&header, sizeof(header), 1, writer->file);
+    for (uint32_t number = player_table_next(&g->players, 1); number != 0;
+         number = player_table_next(&g->players, number + 1)) {
+        if (!player_info(g, number)->golden_unused) {
+            fwrite(&number, sizeof(number), 1, writer->file);
         }
-        for (uint32_t y = 0; y < g->height; y++) {
+    }
 
+    if (!g->tiled) {
+        for (uint32_t y = 0; y < g->height; y++) {
             for (uint32_t x = 0; x < g->width; x++) {
-                if (g->board[x][y].owner == NONE) {
-                    board[(g->height - y - 1) * (g->width + 1) + x] = '.';
-                } else {
-                    board[(g->height - y - 1) * (g->width + 1) + x] = g->board[x][y].owner + '0';
+                uint32_t owner = owner_get(g, field_index(g, x, y));
+                if (owner != NONE) {
+                    snapshot_write_field(writer, x, y, owner);
                 }
             }
-
-            board[(y + 1) * g->width + y] = '\n';
         }
-        board[(g->width + 1) * g->height] = '\0';
     } else {
-        uint64_t bonus_space = 0;
-        for (uint32_t y = 0; y < g->height; y++) {
-            for (uint32_t x = 0; x < g->width; x++) {
-                if (g->board[x][y].owner >= 10) {
-                    bonus_space += 3;
+        // wpis tablicy kafelków jest zajęty, gdy ma epokę tablicy
+        for (uint64_t i = 0; i < g->tiles.capacity; i++) {
+            const field_map_entry *entry = &g->tiles.entries[i];
+            if (entry->epoch != g->tiles.epoch) {
+                continue;
+            }
+            uint64_t tile_x = (entry->key & UINT32_MAX) * TILE_SIDE;
+            uint64_t tile_y = (entry->key >> 32) * TILE_SIDE;
+            for (uint32_t field = 0; field < TILE_CELLS; field++) {
+                uint32_t owner = owner_get(g, entry->value * TILE_CELLS + field);
+                if (owner != NONE && owner != BORDER) {
+                    snapshot_write_field(writer, tile_x + (field & (TILE_SIDE - 1)),
+                                         tile_y + (field >> TILE_BITS), owner);
                 }
             }
         }
-        board = malloc(1 + bonus_space + (uint64_t)(g->width + 1) * g->height * sizeof(char));
-        if (board == NULL) {
+    }
+    fwrite(writer->fields, sizeof(snapshot_field), writer->length, writer->file);
+
+    bool saved = !ferror(writer->file);
+    if (fclose(writer->file) != 0) {
+        saved = false;
+    }
+    free(writer);
+    return saved;
+}
+
+/** @brief Odtwarza stan gry z odwzorowanego w pamięci pliku.
+ * Pola są zajmowane po kolei bez sprawdzania limitu obszarów, który mógłby
+ * być chwilowo przekroczony, a na końcu sprawdzane jest, że żaden gracz go nie przekracza.
+ * @param[in] *data – początek pliku,
+ * @param[in] size  – rozmiar pliku w bajtach, co najmniej rozmiar nagłówka.
+ * @return Wskaźnik na odtworzoną strukturę lub NULL, gdy plik jest niepoprawny
+ * lub zabrakło pamięci.
+ */
+static gamma_t *snapshot_restore(const void *data, uint64_t size) {
+    const snapshot_header *header = data;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != GAMMA_SNAPSHOT_VERSION || header->golden_used > header->players) {
+        return NULL;
+    }
+    // liczba zajętych pól jest porównywana z miejscem w pliku przed mnożeniem,
+    // bo na największych planszach iloczyn z rozmiarem opisu pola by się przekręcił
+    uint64_t remaining = size - sizeof(*header) - header->golden_used * sizeof(uint32_t);
+    if (sizeof(*header) + header->golden_used * sizeof(uint32_t) > size ||
+        header->busy_fields > (uint64_t)header->width * header->height ||
+        header->busy_fields > remaining / sizeof(snapshot_field) ||
+        remaining != header->busy_fields * sizeof(snapshot_field)) {
+        return NULL;
+    }
+    gamma_t *g = gamma_new(header->width, header->height, header->players, header->areas);
+    if (g == NULL) {
+        return NULL;
+    }
+
+    const uint32_t *golden_used = (const uint32_t *)(header + 1);
+    for (uint64_t i = 0; i < header->golden_used; i++) {
+        player *p = valid_player(g, golden_used[i]) ? player_table_touch(&g->players, golden_used[i]) : NULL;
+        if (p == NULL) {
+            gamma_delete(g);
             return NULL;
         }
-        for (uint64_t i = 0; i < bonus_space + (g->width + 1) * g->height; i++) {
-            board[i] = '\n';
+        if (p->golden_unused) {
+            use_golden_move(g, golden_used[i]);
         }
-        uint64_t current_bonus = bonus_space;
-        for (uint32_t y = 0; y < g->height; y++) {
-            bool stop = false;
-            for (uint32_t x = g->width - 1; !stop; x--) {
-                if (g->board[x][y].owner == NONE) {
-                    board[(g->height - y - 1) * (g->width + 1) + x + current_bonus] = '.';
-                } else if (g->board[x][y].owner < 10) {
-                    board[(g->height - y - 1) * (g->width + 1) + x + current_bonus] =
-                            g->board[x][y].owner + '0';
-                } else {
-                    int current_space = (g->height - y - 1) * (g->width + 1) + x + current_bonus;
-                    current_space -= 3;
-                    board[current_space] = '[';
-                    int first_digit = g->board[x][y].owner / 10;
-                    board[current_space + 1] = first_digit + '0';
-                    int second_digit = g->board[x][y].owner - first_digit * 10;
-                    board[current_space + 2] = second_digit + '0';
-                    board[current_space + 3] = ']';
-                    current_bonus -= 3;
-                }
-                if (x == 0)
-                    stop = true;
-            }
+    }
 
+    const snapshot_field *fields = (const snapshot_field *)(golden_used + header->golden_used);
+    for (uint64_t i = 0; i < header->busy_fields; i++) {
+        const snapshot_field *f = &fields[i];
+        if (!valid_player(g, f->owner) || f->x >= g->width || f->y >= g->height ||
+            owner_at(g, f->x, f->y) != NONE || !materialize_tiles(g, f->x, f->y) ||
+            !reserve_golden_index(g) || !reserve_regions(g, 1) ||
+            player_table_touch(&g->players, f->owner) == NULL ||
+            !reserve_frontiers(g, f->owner, board_cell(g, f->x, f->y))) {
+            gamma_delete(g);
+            return NULL;
+        }
+        occupy_field(g, f->owner, board_cell(g, f->x, f->y));
+        hash_field(g, f->x, f->y, f->owner);
+    }
+    for (uint64_t i = 0; i < header->busy_fields; i++) {
+        if (player_info(g, fields[i].owner)->areas > g->max_areas) {
+            gamma_delete(g);
+            return NULL;
         }
-        board[(g->width + 1) * g->height + bonus_space] = '\0';
     }
-    return board;
+    return g;
+}
+
+gamma_t *gamma_load(const char *path) {
+    if (path == NULL) {
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (uint64_t)status.st_size < sizeof(snapshot_header)) {
+        close(fd);
+        return NULL;
+    }
+    uint64_t size = status.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    gamma_t *g = snapshot_restore(data, size);
+    munmap(data, size);
+    return g;
 }
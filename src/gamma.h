@@ -13,27 +13,108 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "bitboard.h"
+#include "field_map.h"
+#include "frontier_table.h"
+#include "player_table.h"
 
 #define NONE 0 ///< oznakowanie pola nie należącego do żadnego gracza
+#define BORDER UINT32_MAX ///< oznakowanie pola ramki otaczającej planszę
 
-/** @brief Struktura jednego pola planszy.
- * Trzyma niezbędne informacje o danym polu.
+/** @brief Struktura opisująca jeden obszar.
+ * Opis jest przypisany do reprezentanta obszaru. Ruch poprawia prostokąt
+ * i liczbę wolnych sąsiadów w czasie stałym, a gdy się nie da (połączenie obszarów,
+ * rozpad obszaru), oznacza opis jako nieaktualny i obszar jest przeliczany
+ * dopiero przy pierwszym pytaniu o niego.
  */
-struct field {
-    struct field *root; ///< wskaźnik na reprezentanta obszaru do którego należy dane pole
-    uint32_t owner;     ///< właściciel pola, liczba dodatnia
-};
-typedef struct field field; ///< field jest w naszym programie typem
+typedef struct {
+    uint64_t size;     ///< liczba pól obszaru, w wolnym opisie numer następnego wolnego opisu
+    uint64_t frontier; ///< liczba wolnych pól sąsiadujących z obszarem
+    uint32_t owner;    ///< właściciel obszaru, @ref NONE w wolnym opisie
+    uint32_t anchor;   ///< indeks dowolnego pola obszaru, od którego zaczyna się przeliczanie
+    uint32_t min_x;    ///< najmniejszy numer kolumny pola obszaru
+    uint32_t min_y;    ///< najmniejszy numer wiersza pola obszaru
+    uint32_t max_x;    ///< największy numer kolumny pola obszaru
+    uint32_t max_y;    ///< największy numer wiersza pola obszaru
+    bool stale;        ///< true, jeśli prostokąt i liczba wolnych sąsiadów wymagają przeliczenia
+} region;
+
+/**
+ * Maksymalna liczba przeszukiwań prowadzonych jednocześnie przy sprawdzaniu podziału obszaru
+ */
+#define SPLIT_SEARCHES 4
+
+/** @brief Stan przeszukiwania obszaru po odebraniu z niego pola.
+ * Z każdego sąsiada odebranego pola prowadzone jest osobne przeszukiwanie wszerz.
+ * Przeszukiwania, które się spotkały, tworzą grupę; na końcu każda grupa to jedna
+ * część obszaru.
+ */
+typedef struct {
+    uint32_t *queue[SPLIT_SEARCHES];    ///< kolejki przeszukiwań, zarazem listy odwiedzonych pól
+    uint32_t head[SPLIT_SEARCHES];      ///< początki kolejek
+    uint32_t length[SPLIT_SEARCHES];    ///< długości kolejek
+    uint32_t capacity[SPLIT_SEARCHES];  ///< rozmiary tablic @p queue
+    uint32_t group[SPLIT_SEARCHES];     ///< przeszukiwanie, które reprezentuje grupę danego przeszukiwania
+    uint32_t searches;                  ///< liczba prowadzonych przeszukiwań
+    uint32_t keep;                      ///< grupa, która zachowuje dotychczasowe drzewo obszaru
+    uint64_t moved_fields;              ///< liczba pól pozostałych grup
+    field_map visited;                  ///< numer przeszukiwania, które odwiedziło dane pole
+} split_search;
+
+/** @brief Jedna zapisana w dzienniku poprzednia wartość.
+ */
+typedef struct {
+    uint32_t kind;  ///< rodzaj zmienionej wartości
+    uint32_t index; ///< indeks pola, numer węzła lub pozycja w tablicy
+    uint64_t value; ///< poprzednia wartość
+} journal_entry;
 
-/** @brief Struktura jednego gracza.
- * Trzyma niezbędne informacje o danym graczu.
+/** @brief Zapamiętany w dzienniku opis gracza sprzed ruchu.
  */
 typedef struct {
-    uint64_t busy_fields; ///< ilość pól zajętych przez gracza, liczba nieujemna
-    uint64_t free_fields; ///< ilość wolnych pól sąsiadujących z polami gracza, liczba nieujemna
-    uint32_t areas;       ///< ile obszarów tworzą zajęte przez gracza pola, liczba nieujemna
-    bool golden_unused;   ///< true jeżeli gracz nie użył jeszcze złotego ruchu, false wpp
-} player;
+    uint32_t number; ///< numer gracza
+    player record;   ///< opis gracza sprzed ruchu
+} journal_player;
+
+/** @brief Zapamiętany w dzienniku opis obszaru sprzed zmiany.
+ */
+typedef struct {
+    uint32_t id;   ///< numer opisu obszaru
+    region record; ///< opis obszaru sprzed zmiany
+} journal_region;
+
+/** @brief Początek jednego ruchu w dzienniku wraz z licznikami sprzed ruchu.
+ */
+typedef struct {
+    uint64_t entry_start;  ///< pozycja pierwszego wpisu ruchu
+    uint64_t player_start; ///< pozycja pierwszego opisu gracza zapamiętanego przy ruchu
+    uint64_t region_start; ///< pozycja pierwszego opisu obszaru zapamiętanego przy ruchu
+    uint64_t busy_count;   ///< liczba zajętych pól
+    uint64_t hash;         ///< skrót stanu gry
+    uint32_t field;        ///< indeks pola, na które wykonano ruch
+    uint32_t spare_count;  ///< liczba użytych węzłów zapasowych
+    uint32_t region_count; ///< liczba użytych opisów obszarów
+    uint32_t free_region;  ///< pierwszy wolny opis obszaru
+    uint32_t risky_count;  ///< liczba pól ryzykownych
+} journal_move;
+
+/** @brief Dziennik ruchów pozwalający je cofać.
+ */
+typedef struct {
+    bool enabled;               ///< true, jeśli ruchy są zapisywane
+    journal_entry *entries;     ///< poprzednie wartości zmienionych pól i węzłów
+    uint64_t entry_count;       ///< liczba wpisów
+    uint64_t entry_capacity;    ///< rozmiar tablicy @p entries
+    journal_player *players;    ///< opisy graczy sprzed ruchów
+    uint64_t player_count;      ///< liczba zapamiętanych opisów graczy
+    uint64_t player_capacity;   ///< rozmiar tablicy @p players
+    journal_region *regions;    ///< opisy obszarów sprzed zmian
+    uint64_t region_count;      ///< liczba zapamiętanych opisów obszarów
+    uint64_t region_capacity;   ///< rozmiar tablicy @p regions
+    journal_move *moves;        ///< kolejne ruchy
+    uint64_t move_count;        ///< liczba ruchów w dzienniku
+    uint64_t move_capacity;     ///< rozmiar tablicy @p moves
+} move_journal;
 
 /** @brief Struktura przechowująca stan gry.
  * Trzyma niezbędne informacje o stanie gry.
@@ -42,19 +123,79 @@ typedef struct {
     uint32_t width;        ///< szerokość planszy, liczba dodatnia
     uint32_t height;       ///< wysokość planszy, liczba dodatnia
     uint32_t player_count; ///< liczba graczy, liczba dodatnia
-    player *players;       ///< tablica graczy
+    player_table players;  ///< opisy graczy
     uint32_t max_areas;    ///< maksymalna liczba obszarów, jakie może zająć jeden gracz, liczba dodatnia
-    field **board;         ///< dwuwymiarowa tablica pól
+    void *owners;          ///< właściciele pól planszy otoczonej ramką pól @ref BORDER, wierszami,
+                           ///< a przy planszy z kafelkami – kolejne kafelki, każdy wierszami
+    uint32_t owner_size;   ///< rozmiar wpisu tablicy @p owners w bajtach, najmniejszy mieszczący
+                           ///< numery wszystkich graczy i @ref BORDER jako największą wartość
+    uint64_t busy_count;   ///< liczba pól zajętych przez wszystkich graczy
+    uint64_t hash;         ///< skrót Zobrista stanu gry, patrz @ref gamma_hash
+    uint32_t *roots;       ///< węzły drzew obszarów odpowiadające polom, ten sam układ co @p owners;
+                           ///< węzeł trzyma numer rodzica lub, u reprezentanta, numer opisu obszaru
+    bool tiled;            ///< true, jeśli plansza składa się z kafelków tworzonych przy pierwszym zapisie
+    uint32_t cell_count;   ///< liczba używanych miejsc w tablicach @p owners i @p roots
+    uint32_t cell_capacity;   ///< rozmiar tablic @p owners i @p roots przy planszy z kafelkami
+    uint32_t *tile_adjacent;  ///< numery kafelków z kwadratu 3 na 3 wokół każdego kafelka, wierszami
+    uint64_t *tile_keys;      ///< współrzędne każdego kafelka w postaci klucza tablicy @p tiles
+    field_map tiles;          ///< numer kafelka o danych współrzędnych
+    uint32_t *spare_roots;    ///< węzły zapasowe, nadawane polom odłączonym od obszaru
+    uint32_t spare_count;     ///< liczba użytych węzłów zapasowych
+    uint32_t spare_capacity;  ///< rozmiar tablicy @p spare_roots
+    field_map moved;          ///< węzeł zapasowy pola, którego własny węzeł został w starym drzewie
+    region *regions;          ///< opisy obszarów
+    uint32_t region_count;    ///< liczba użytych do tej pory opisów obszarów
+    uint32_t region_capacity; ///< rozmiar tablicy @p regions
+    uint32_t free_region;     ///< numer pierwszego wolnego opisu obszaru
+    bool regions_tracked;     ///< true, jeśli ruchy poprawiają prostokąty i liczby wolnych sąsiadów
+                              ///< obszarów; do pierwszego pytania o obszar wszystkie opisy są nieaktualne
+    split_search search;      ///< pamięć pomocnicza do sprawdzania podziału obszaru
+    uint32_t *risky_fields;   ///< pola sąsiadujące z innymi graczami, których odebranie
+                              ///< może rozspójnić obszar właściciela
+    uint32_t risky_count;     ///< liczba pól w tablicy @p risky_fields
+    uint32_t risky_capacity;  ///< rozmiar tablicy @p risky_fields
+    field_map risky_position; ///< pozycja pola w tablicy @p risky_fields
+    bitboard *bits;           ///< plansza bitowa, NULL dla większych plansz lub większej liczby graczy
+    bool frontiers_tracked;   ///< true, jeśli zbiory @p frontiers i @p contacts są utrzymywane
+    frontier_table frontiers; ///< wolne pola sąsiadujące z polami każdego gracza
+    frontier_table contacts;  ///< pola innych graczy sąsiadujące z polami każdego gracza
+    move_journal journal;     ///< dziennik ruchów do cofania
 } gamma_t;
 
+/** @brief Współrzędne pola planszy.
+ */
+typedef struct {
+    uint32_t x; ///< numer kolumny
+    uint32_t y; ///< numer wiersza
+} field_position;
+
+/** @brief Opis obszaru gracza.
+ */
+typedef struct {
+    uint32_t player;   ///< właściciel obszaru
+    uint64_t size;     ///< liczba pól obszaru
+    uint32_t min_x;    ///< najmniejszy numer kolumny pola obszaru
+    uint32_t min_y;    ///< najmniejszy numer wiersza pola obszaru
+    uint32_t max_x;    ///< największy numer kolumny pola obszaru
+    uint32_t max_y;    ///< największy numer wiersza pola obszaru
+    uint64_t frontier; ///< liczba wolnych pól sąsiadujących z obszarem
+} region_info;
+
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
  * @param[in] width   – szerokość planszy, liczba dodatnia,
  * @param[in] height  – wysokość planszy, liczba dodatnia,
- * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia mniejsza od @ref BORDER,
  * @param[in] areas   – maksymalna liczba obszarów,
  *                      jakie może zająć jeden gracz, liczba dodatnia.
+ * Plansza, która razem z ramką ma co najmniej 2^30 pól albo na którą w całości
+ * zabrakło pamięci, jest dzielona na kafelki 64 na 64 tworzone dopiero przy
+ * pierwszym ruchu w ich pobliżu, więc pamięć rośnie z zajętą częścią planszy.
+ * Pola planszy (przy planszy z kafelkami – pola utworzonych kafelków) oraz pola
+ * odłączane od obszarów przez złote ruchy dzielą pulę 2^30 węzłów. Gdy się ona
+ * wyczerpie, @ref gamma_move i @ref gamma_golden_move odrzucają także dozwolone
+ * ruchy, więc na planszy z kafelkami da się zająć pola w najwyżej około 2^18 kafelkach.
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
  * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
  */
@@ -68,6 +209,33 @@ gamma_t *gamma_new(uint32_t width, uint32_t height,
  */
 void gamma_delete(gamma_t *g);
 
+/** @brief Tworzy niezależną kopię stanu gry.
+ * Węzły drzew obszarów wskazują rodziców numerami, a nie wskaźnikami, więc
+ * kopia powstaje przez skopiowanie kolejnych tablic w całości, bez przeglądania
+ * planszy pole po polu. Ruchy wykonane na kopii nie zmieniają oryginału i odwrotnie.
+ * @param[in] g       – wskaźnik na kopiowaną strukturę.
+ * Kopia ma wyłączony dziennik ruchów.
+ * @return Wskaźnik na kopię lub NULL, gdy @p g jest NULL lub zabrakło pamięci.
+ */
+gamma_t *gamma_clone(gamma_t *g);
+
+/** @brief Włącza lub wyłącza zapisywanie ruchów do cofania.
+ * Dziennik rośnie z każdym ruchem, więc domyślnie jest wyłączony.
+ * Wyłączenie dziennika usuwa zapisane ruchy.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] enabled – @p true, jeśli ruchy mają być zapisywane.
+ */
+void gamma_journal_enable(gamma_t *g, bool enabled);
+
+/** @brief Cofa ostatni zapisany ruch.
+ * Przywraca właścicieli pól, węzły drzew obszarów, opisy obszarów i graczy
+ * sprzed ruchu w czasie proporcjonalnym do liczby zmian, jakie ruch wprowadził.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli ruch został cofnięty, a @p false, gdy dziennik
+ * jest wyłączony lub pusty albo zabrakło pamięci.
+ */
+bool gamma_undo(gamma_t *g);
+
 /** @brief Wykonuje ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
@@ -78,7 +246,8 @@ void gamma_delete(gamma_t *g);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy ruch jest nielegalny lub któryś z parametrów jest niepoprawny.
+ * gdy ruch jest nielegalny, któryś z parametrów jest niepoprawny
+ * lub zabrakło pamięci albo węzłów (zob. @ref gamma_new).
  */
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
@@ -93,11 +262,52 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny
- * lub któryś z parametrów jest niepoprawny.
+ * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny,
+ * któryś z parametrów jest niepoprawny lub zabrakło pamięci albo węzłów
+ * (zob. @ref gamma_new).
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/** @brief Wyznacza pola, na które gracz może wykonać zwykły ruch.
+ * Gdy gracz może jeszcze zająć nowy obszar, są to wszystkie wolne pola, wypisywane
+ * wierszami. W przeciwnym razie są to wolne pola sąsiadujące z jego polami, w dowolnej
+ * kolejności, a ich wyznaczenie kosztuje tyle, ile jest takich pól. Pierwsze wywołanie
+ * tej lub następnej funkcji przegląda całą planszę, a od tej pory każdy ruch poprawia
+ * zbiory pól sąsiadujących z polami graczy.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player   – numer gracza, liczba dodatnia niewiększa od wartości
+ *                       @p players z funkcji @ref gamma_new,
+ * @param[out] out     – tablica na współrzędne pól, może być NULL, gdy @p capacity jest zerem,
+ * @param[in] capacity – rozmiar tablicy @p out.
+ * @return Liczba wszystkich takich pól, do @p out trafia najwyżej @p capacity pierwszych,
+ * lub zero, jeśli któryś z parametrów jest niepoprawny.
+ */
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player, field_position *out, uint64_t capacity);
+
+/** @brief Wyznacza pola, na które gracz może wykonać złoty ruch.
+ * Gdy gracz jest na limicie obszarów, sprawdzane są tylko pola innych graczy
+ * sąsiadujące z jego polami, a w przeciwnym razie wszystkie pola innych graczy.
+ * Każde z nich jest sprawdzane tak jak w @ref gamma_golden_move. Kolejność pól jest dowolna.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player   – numer gracza, liczba dodatnia niewiększa od wartości
+ *                       @p players z funkcji @ref gamma_new,
+ * @param[out] out     – tablica na współrzędne pól, może być NULL, gdy @p capacity jest zerem,
+ * @param[in] capacity – rozmiar tablicy @p out.
+ * @return Liczba wszystkich takich pól, do @p out trafia najwyżej @p capacity pierwszych,
+ * lub zero, jeśli któryś z parametrów jest niepoprawny lub zabrakło pamięci.
+ */
+uint64_t gamma_golden_legal_moves(gamma_t *g, uint32_t player, field_position *out, uint64_t capacity);
+
+/** @brief Podaje skrót stanu gry.
+ * Skrót zależy od wymiarów planszy, liczby graczy i obszarów, właścicieli pól
+ * oraz tego, którzy gracze wykonali już złoty ruch. Nie zależy od kolejności ruchów,
+ * więc ta sama pozycja osiągnięta różnymi drogami ma ten sam skrót. Jest poprawiany
+ * przy każdym ruchu w czasie stałym.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Skrót stanu gry lub zero, gdy @p g jest NULL.
+ */
+uint64_t gamma_hash(gamma_t *g);
+
 /** @brief Podaje liczbę pól zajętych przez gracza.
  * Podaje liczbę pól zajętych przez gracza @p player.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -132,6 +342,82 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/** @brief Opisuje obszar, do którego należy pole (@p x, @p y).
+ * Opis jest trzymany przy reprezentancie obszaru, więc zwykle kosztuje tyle,
+ * co znalezienie reprezentanta. Obszar połączony z innym lub rozbity złotym ruchem
+ * jest przy pierwszym pytaniu przeglądany w całości. Do pierwszego pytania o obszar
+ * ruchy nie poprawiają opisów, więc wtedy przeglądany jest każdy obszar.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
+ *                      @p width z funkcji @ref gamma_new,
+ * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
+ *                      @p height z funkcji @ref gamma_new,
+ * @param[out] info   – wskaźnik na miejsce na opis obszaru.
+ * @return Wartość @p true, jeśli obszar został opisany, a @p false, gdy pole
+ * jest wolne, któryś z parametrów jest niepoprawny lub zabrakło pamięci.
+ */
+bool gamma_region_info(gamma_t *g, uint32_t x, uint32_t y, region_info *info);
+
+/** @brief Opisuje obszary gracza.
+ * Przegląda opisy obszarów, a nie planszę. Kolejność obszarów jest dowolna.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player   – numer gracza, liczba dodatnia niewiększa od wartości
+ *                       @p players z funkcji @ref gamma_new,
+ * @param[out] out     – tablica na opisy obszarów, może być NULL, gdy @p capacity jest zerem,
+ * @param[in] capacity – rozmiar tablicy @p out.
+ * @return Liczba obszarów gracza, do @p out trafia najwyżej @p capacity pierwszych,
+ * lub zero, jeśli któryś z parametrów jest niepoprawny lub zabrakło pamięci.
+ */
+uint64_t gamma_player_regions(gamma_t *g, uint32_t player, region_info *out, uint64_t capacity);
+
+/** @brief Funkcja odbierająca kolejne fragmenty napisu opisującego planszę.
+ * @param[in] data    – wskaźnik na fragment napisu, bez kończącego znaku '\0',
+ * @param[in] length  – długość fragmentu,
+ * @param[in] context – wskaźnik przekazany do @ref gamma_board_write.
+ */
+typedef void (*board_sink)(const char *data, size_t length, void *context);
+
+/** @brief Wypisuje napis opisujący stan planszy kawałkami.
+ * Przekazuje funkcji @p sink kolejne fragmenty tego samego napisu, który
+ * daje @ref gamma_board. Plansza jest opisywana wiersz po wierszu w buforze
+ * o stałym rozmiarze, więc funkcja nie alokuje pamięci.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] sink    – funkcja odbierająca fragmenty napisu,
+ * @param[in] context – wskaźnik przekazywany funkcji @p sink.
+ * @return Wartość @p true, jeśli plansza została wypisana, a @p false,
+ * gdy któryś z parametrów jest niepoprawny.
+ */
+bool gamma_board_write(gamma_t *g, board_sink sink, void *context);
+
+/** @brief Wypisuje kawałkami napis opisujący prostokątny fragment planszy.
+ * Fragment jest opisany tak samo jak cała plansza w @ref gamma_board, w tym
+ * z tym samym sposobem zapisu numerów graczy. Koszt zależy tylko od rozmiaru fragmentu.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x0      – numer pierwszej kolumny fragmentu,
+ * @param[in] y0      – numer pierwszego (najniższego) wiersza fragmentu,
+ * @param[in] width   – szerokość fragmentu, liczba dodatnia,
+ * @param[in] height  – wysokość fragmentu, liczba dodatnia,
+ * @param[in] sink    – funkcja odbierająca fragmenty napisu,
+ * @param[in] context – wskaźnik przekazywany funkcji @p sink.
+ * @return Wartość @p true, jeśli fragment został wypisany, a @p false,
+ * gdy któryś z parametrów jest niepoprawny, np. fragment wystaje poza planszę.
+ */
+bool gamma_board_region_write(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height,
+                              board_sink sink, void *context);
+
+/** @brief Daje napis opisujący prostokątny fragment planszy.
+ * Alokuje w pamięci bufor z takim napisem, jaki wypisuje
+ * @ref gamma_board_region_write. Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x0      – numer pierwszej kolumny fragmentu,
+ * @param[in] y0      – numer pierwszego (najniższego) wiersza fragmentu,
+ * @param[in] width   – szerokość fragmentu, liczba dodatnia,
+ * @param[in] height  – wysokość fragmentu, liczba dodatnia.
+ * @return Wskaźnik na zaalokowany bufor lub NULL, jeśli nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+char *gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy. Przykład znajduje się w pliku gamma_test.c.
@@ -142,4 +428,30 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 char *gamma_board(gamma_t *g);
 
+/**
+ * Wersja formatu pliku ze stanem gry
+ */
+#define GAMMA_SNAPSHOT_VERSION 1
+
+/** @brief Zapisuje stan gry do pliku.
+ * Plik zawiera wymiary planszy, parametry gry, numery graczy, którzy wykonali
+ * już złoty ruch, oraz współrzędne i właścicieli zajętych pól, więc jego rozmiar
+ * zależy od liczby zajętych pól, a nie od rozmiaru planszy. Liczby są zapisane
+ * w porządku bajtów maszyny.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] path    – ścieżka do tworzonego pliku.
+ * @return Wartość @p true, jeśli stan został zapisany, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub nie udało się zapisać pliku.
+ */
+bool gamma_save(gamma_t *g, const char *path);
+
+/** @brief Odtwarza stan gry zapisany przez @ref gamma_save.
+ * Plik jest odwzorowywany w pamięci i czytany raz po kolei, a obszary graczy,
+ * liczby wolnych pól i indeks złotych ruchów są odtwarzane w tym samym przejściu.
+ * @param[in] path    – ścieżka do pliku ze stanem gry.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * odczytać pliku, plik jest niepoprawny lub zabrakło pamięci.
+ */
+gamma_t *gamma_load(const char *path);
+
 #endif /* GAMMA_H */
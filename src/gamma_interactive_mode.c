@@ -6,7 +6,10 @@
  * @date 17.05.2020
  */
 
+#define _XOPEN_SOURCE 700 ///< udostępnia sigaction przy kompilacji z -std=c11
+
 #include "gamma_interactive_mode.h"
+#include "input.h"
 
 /** @brief Funkcja wyłączająca wypisywanie wczytywanych znaków do terminala.
  * Funkcja podesłana w komentarzu do części drugiej (dziękuję bardzo za pomocne wyjaśnienia :) )
@@ -30,40 +33,295 @@ static void enable_terminal_echo(struct termios oldattr)
 }
 
 
+/**
+ * Rozmiar bufora na wiersz z informacjami o graczu
+ */
+#define INFO_LENGTH 96
+
+/**
+ * Liczba kolumn terminala przyjmowana, gdy nie da się odczytać jego rozmiaru
+ */
+#define DEFAULT_COLUMNS 80
+
+/**
+ * Liczba wierszy terminala przyjmowana, gdy nie da się odczytać jego rozmiaru
+ */
+#define DEFAULT_ROWS 24
+
+/** @brief Obraz planszy i informacji o graczu wyświetlony na terminalu.
+ */
+typedef struct {
+    char *board;            ///< opis planszy, wiersze zakończone znakiem '\n'
+    size_t length;          ///< długość opisu planszy
+    size_t capacity;        ///< rozmiar tablicy @p board
+    char info[INFO_LENGTH]; ///< wiersz z informacjami o graczu
+} frame;
+
+/** @brief Stan terminala w grze interaktywnej.
+ * Na terminalu widoczne jest okno planszy, które podąża za kursorem.
+ */
+typedef struct {
+    frame frames[2];  ///< obraz wyświetlony i obraz następnego stanu, po narysowaniu zamieniają się rolami
+    frame *shown;     ///< obraz wyświetlony na terminalu, NULL jeśli terminal trzeba narysować od nowa
+    uint32_t left;    ///< numer pierwszej widocznej kolumny planszy, liczony od 0
+    uint32_t top;     ///< numer pierwszego widocznego wiersza planszy, liczony od 0 od góry
+    uint32_t width;   ///< liczba widocznych kolumn planszy
+    uint32_t height;  ///< liczba widocznych wierszy planszy
+} screen;
+
+/**
+ * Flaga ustawiana przez obsługę sygnału SIGWINCH
+ */
+static volatile sig_atomic_t terminal_resized = 0;
+
+/** @brief Obsługuje zmianę rozmiaru terminala.
+ */
+static void handle_resize(int signal) {
+    (void)signal;
+    terminal_resized = 1;
+}
+
+/** @brief Dopisuje fragment opisu planszy do obrazu @p context.
+ */
+static void frame_append(const char *data, size_t length, void *context) {
+    frame *f = context;
+    if (f->length + length > f->capacity) {
+        size_t capacity = 2 * f->capacity + length;
+        char *board = realloc(f->board, capacity);
+        if (board == NULL) {
+            exit(1); // nie starczyło pamięci na zapisanie stanu gry, nie można kontynuuować
+        }
+        f->board = board;
+        f->capacity = capacity;
+    }
+    memcpy(f->board + f->length, data, length);
+    f->length += length;
+}
+
+/** @brief Zapisuje informacje o graczu w buforze.
+ * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player    – numer gracza, liczba dodatnia,
+ * @param[out] *info    – bufor o rozmiarze INFO_LENGTH.
+ */
+static void player_info_text(gamma_t *g, uint32_t player, char *info) {
+    uint64_t busy_fields = gamma_busy_fields(g, player);
+    uint64_t free_fields = gamma_free_fields(g, player);
+
+    snprintf(info, INFO_LENGTH, "PLAYER %d BUSY: %ld FREE: %ld%s", player, busy_fields, free_fields,
+             gamma_golden_possible(g, player) ? " G" : "");
+}
+
+/** @brief Wypisuje fragment opisu planszy na standardowe wyjście.
+ */
+static void print_board(const char *data, size_t length, void *context) {
+    (void)context;
+    fwrite(data, 1, length, stdout);
+}
+
 /** @brief Wypisuje informacje o graczu.
  * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] player    – numer gracza, liczba dodatnia
  */
 static void print_player_info(gamma_t *g, uint32_t player) {
-    uint64_t busy_fields = gamma_busy_fields(g, player);
-    uint64_t free_fields = gamma_free_fields(g, player);
+    char info[INFO_LENGTH];
+    player_info_text(g, player, info);
+    printf("%s\n", info);
+}
 
-    printf("PLAYER %d BUSY: %ld FREE: %ld", player, busy_fields, free_fields);
-    if (gamma_golden_possible(g,player)) {
-        printf(" G");
+/** @brief Tworzy obraz widocznej części planszy i informacji o graczu.
+ * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] *s        – wskaźnik na stan terminala,
+ * @param[in] player    – numer gracza wykonującego ruch,
+ * @param[out] *f       – wskaźnik na obraz.
+ */
+static void frame_render(gamma_t *g, const screen *s, uint32_t player, frame *f) {
+    f->length = 0;
+    // wiersze okna są liczone od góry, a wiersze planszy od dołu
+    gamma_board_region_write(g, s->left, g->height - s->top - s->height, s->width, s->height, frame_append, f);
+    player_info_text(g, player, f->info);
+}
+
+/** @brief Rysuje cały obraz od nowa na wyczyszczonym terminalu.
+ */
+static void frame_draw_full(const frame *f) {
+    printf(CLEAR_CONSOLE);
+    fwrite(f->board, 1, f->length, stdout);
+    printf("%s\n", f->info);
+}
+
+/** @brief Przerysowuje zmienione znaki jednego wiersza terminala.
+ * Gdy długość wiersza się nie zmieniła, wypisywane są tylko zmienione ciągi znaków,
+ * a w przeciwnym razie wiersz od pierwszej różnicy do końca.
+ * @param[in] row                 – numer wiersza terminala, liczony od 1,
+ * @param[in] *old, old_length    – poprzednia zawartość wiersza,
+ * @param[in] *new, new_length    – nowa zawartość wiersza.
+ */
+static void draw_row_changes(uint32_t row, const char *old, size_t old_length,
+                             const char *new, size_t new_length) {
+    if (old_length != new_length) {
+        size_t first = 0;
+        while (first < old_length && first < new_length && old[first] == new[first]) {
+            first++;
+        }
+        printf("\033[%u;%zuH", row, first + 1);
+        fwrite(new + first, 1, new_length - first, stdout);
+        printf("\033[K"); // czyścimy resztę dłuższego dotąd wiersza
+        return;
+    }
+    size_t i = 0;
+    while (i < new_length) {
+        if (old[i] == new[i]) {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < new_length && old[i] != new[i]) {
+            i++;
+        }
+        printf("\033[%u;%zuH", row, start + 1);
+        fwrite(new + start, 1, i - start, stdout);
+    }
+}
+
+/** @brief Przerysowuje tylko te fragmenty terminala, które różnią się między obrazami.
+ * Oba obrazy opisują tę samą planszę, więc mają tyle samo wierszy.
+ * @param[in] *old      – obraz wyświetlony na terminalu,
+ * @param[in] *new      – obraz do wyświetlenia.
+ */
+static void frame_draw_changes(const frame *old, const frame *new) {
+    const char *old_row = old->board;
+    const char *new_row = new->board;
+    const char *new_end = new->board + new->length;
+    uint32_t row = 1;
+    while (new_row < new_end) {
+        const char *old_row_end = memchr(old_row, '\n', old->board + old->length - old_row);
+        const char *new_row_end = memchr(new_row, '\n', new_end - new_row);
+        draw_row_changes(row, old_row, old_row_end - old_row, new_row, new_row_end - new_row);
+        old_row = old_row_end + 1;
+        new_row = new_row_end + 1;
+        row++;
+    }
+    if (strcmp(old->info, new->info) != 0) {
+        printf("\033[%u;1H%s\033[K", row, new->info);
+    }
+}
+
+/** @brief Dopasowuje okno do rozmiaru terminala.
+ * Po zmianie rozmiaru terminal jest rysowany od nowa.
+ * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in, out] *s   – wskaźnik na stan terminala.
+ */
+static void screen_resize(gamma_t *g, screen *s) {
+    uint32_t columns = DEFAULT_COLUMNS;
+    uint32_t rows = DEFAULT_ROWS;
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+        columns = size.ws_col;
+        rows = size.ws_row;
+    }
+    rows = rows > 1 ? rows - 1 : 1; // ostatni wiersz zajmują informacje o graczu
+
+    s->width = columns < g->width ? columns : g->width;
+    s->height = rows < g->height ? rows : g->height;
+    if (s->left > g->width - s->width) {
+        s->left = g->width - s->width;
+    }
+    if (s->top > g->height - s->height) {
+        s->top = g->height - s->height;
+    }
+    s->shown = NULL;
+}
+
+/** @brief Przesuwa okno tak, żeby kursor był widoczny.
+ * @param[in, out] *s   – wskaźnik na stan terminala,
+ * @param[in] x, y      – pozycja kursora na planszy, liczby dodatnie.
+ * @return Wartość @p true, jeśli okno zostało przesunięte, a @p false wpp.
+ */
+static bool screen_follow(screen *s, uint32_t x, uint32_t y) {
+    uint32_t left = s->left;
+    uint32_t top = s->top;
+    if (x - 1 < s->left) {
+        s->left = x - 1;
+    } else if (x - 1 - s->left >= s->width) {
+        s->left = x - s->width;
+    }
+    if (y - 1 < s->top) {
+        s->top = y - 1;
+    } else if (y - 1 - s->top >= s->height) {
+        s->top = y - s->height;
+    }
+    return s->left != left || s->top != top;
+}
+
+/** @brief Rysuje okno planszy i informacje o graczu.
+ * Jeśli terminal pokazuje poprzedni obraz, wypisywane są tylko różnice,
+ * więc koszt jest ograniczony przez rozmiar terminala, a nie planszy.
+ * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in, out] *s   – wskaźnik na stan terminala,
+ * @param[in] player    – numer gracza wykonującego ruch.
+ */
+static void screen_draw(gamma_t *g, screen *s, uint32_t player) {
+    frame *next = s->shown == &s->frames[0] ? &s->frames[1] : &s->frames[0];
+    frame_render(g, s, player, next);
+    if (s->shown == NULL) {
+        frame_draw_full(next);
+    } else {
+        frame_draw_changes(s->shown, next);
+    }
+    s->shown = next;
+}
+
+void move_cursor_to_center(uint32_t x, uint32_t y) {
+    printf("\033[%d;%dH", y, x);
+}
+
+/** @brief Czeka na naciśnięcie klawisza.
+ * Zmiana rozmiaru terminala w trakcie czekania od razu przerysowuje okno.
+ * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in, out] *s   – wskaźnik na stan terminala,
+ * @param[in] player    – numer gracza wykonującego ruch,
+ * @param[in] x, y      – pozycja kursora na planszy, liczby dodatnie.
+ */
+static void wait_for_key(gamma_t *g, screen *s, uint32_t player, uint32_t x, uint32_t y) {
+    while (true) {
+        if (terminal_resized) {
+            terminal_resized = 0;
+            screen_resize(g, s);
+            screen_follow(s, x, y);
+            screen_draw(g, s, player);
+            move_cursor_to_center(x - s->left, y - s->top);
+        }
+        fflush(stdout); // wejście nie przechodzi przez stdio, więc samo nie opróżni wyjścia
+        if (input_pending()) {
+            return;
+        }
+        struct pollfd key = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&key, 1, -1) >= 0 || errno != EINTR) {
+            return;
+        }
     }
-    printf("\n");
 }
 
 /** @brief Obsługuje polecenia gracza.
  * Wczytuje znaki z wejścia bez buforowania i odpowiednio porusza kursorem lub wykonuje ruch.
  * @param[in] *g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in, out] *s   – wskaźnik na stan terminala,
  * @param[in] player    – numer gracza, liczba dodatnia,
- * @param[in, out] x, y - aktualna pozycja kursora, liczby nieujemne
+ * @param[in, out] x, y - aktualna pozycja kursora, liczby dodatnie
  */
-static void interactive_move(gamma_t *g, uint32_t player, uint32_t *x, uint32_t *y, bool *game_shut_down) {
+static void interactive_move(gamma_t *g, screen *s, uint32_t player, uint32_t *x, uint32_t *y,
+                             bool *game_shut_down) {
     bool move_made = false;
     while (!move_made) {
-        int ch = getchar();
+        wait_for_key(g, s, player, *x, *y);
+        int ch = input_char();
         if (ch == '\033') { // strzałka daje nam trzy znaki : '\033', '[' i jeden z 'A', 'B', 'C', 'D'
-            getchar(); // omijamy '['
-            ch = getchar();
+            input_char(); // omijamy '['
+            ch = input_char();
 
             if (!((ch == 'A' && g->height - *y == g->height - 1) || (ch == 'B' && g->height - *y == 0)
                   || (ch == 'C' && *x == g->width) || (ch == 'D' && *x - 1 == 0))) {
 
-                printf("\033[1%c", ch); // poruszamy kursorem odpowiednio
-
                 if (ch == 'A') {
                     (*y)--;
                 } else if (ch == 'B') {
@@ -73,6 +331,11 @@ static void interactive_move(gamma_t *g, uint32_t player, uint32_t *x, uint32_t
                 } else if (ch == 'D') {
                     (*x)--;
                 }
+
+                if (screen_follow(s, *x, *y)) {
+                    screen_draw(g, s, player);
+                }
+                move_cursor_to_center(*x - s->left, *y - s->top); // poruszamy kursorem odpowiednio
             }
 
         } else if (ch == ' ') {
@@ -93,41 +356,37 @@ static void interactive_move(gamma_t *g, uint32_t player, uint32_t *x, uint32_t
     }
 }
 
-void move_cursor_to_center(uint32_t x, uint32_t y) {
-    printf("\033[%d;%dH", y, x);
-}
-
 void interactive_play(gamma_t *g) {
     struct termios terminal_settings = disable_terminal_echo();
 
+    // bez SA_RESTART, żeby sygnał przerywał czekanie na klawisz
+    struct sigaction resize_action, old_resize_action;
+    memset(&resize_action, 0, sizeof(resize_action));
+    resize_action.sa_handler = handle_resize;
+    sigemptyset(&resize_action.sa_mask);
+    sigaction(SIGWINCH, &resize_action, &old_resize_action);
+
     uint32_t x = (uint64_t)(g->width + 1) / 2;
     uint32_t y = (uint64_t)(g->height + 1) / 2;
 
-    printf(CLEAR_CONSOLE);
     bool end = false;
     bool game_shut_down = false;
-    char *board_string = NULL;
+    screen s = {{{NULL, 0, 0, ""}, {NULL, 0, 0, ""}}, NULL, 0, 0, 0, 0};
+    screen_resize(g, &s);
 
     while (!end && !game_shut_down) {
         end = true;
         for (uint32_t player = 0; player < g->player_count; player++) {
-            if (g->players[player].free_fields > 0 || g->players[player].golden_unused) {
-                printf(CLEAR_CONSOLE);
-                board_string = gamma_board(g);
-                if (board_string != NULL) {
-                    printf(board_string);
-                    free(board_string);
-                } else {
-                    gamma_delete(g);
-                    exit(1); // nie starczyło pamięci na zapisanie stanu gry, nie można kontynuuować
-                }
-                print_player_info(g, player + 1);
+            if (player_table_get(&g->players, player + 1)->free_fields > 0 ||
+                player_table_get(&g->players, player + 1)->golden_unused) {
+                screen_follow(&s, x, y);
+                screen_draw(g, &s, player + 1);
 
-                move_cursor_to_center(x,y);
+                move_cursor_to_center(x - s.left, y - s.top);
 
                 end = false; // jeśli któryś z graczy może wykonać ruch to nie kończymy
 
-                interactive_move(g, player + 1, &x, &y, &game_shut_down);
+                interactive_move(g, &s, player + 1, &x, &y, &game_shut_down);
                 if (game_shut_down) {
                     break;
                 }
@@ -135,13 +394,16 @@ void interactive_play(gamma_t *g) {
         }
     }
 
+    // końcowa plansza zostaje w historii terminala, więc wypisujemy ją całą, a nie tylko widok
     printf(CLEAR_CONSOLE);
-    board_string = gamma_board(g);
-    printf(board_string);
-    free(board_string);
+    gamma_board_write(g, print_board, NULL);
     for (uint32_t player = 0; player < g->player_count; player++) {
         print_player_info(g, player + 1);
     }
+    fflush(stdout);
+    free(s.frames[0].board);
+    free(s.frames[1].board);
 
+    sigaction(SIGWINCH, &old_resize_action, NULL);
     enable_terminal_echo(terminal_settings);
 }
@@ -10,7 +10,12 @@
 #define GAMMA_GAMMA_INTERACTIVE_MODE_H
 
 #include "gamma.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
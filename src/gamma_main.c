@@ -1,13 +1,35 @@
 #include "input.h"
 #include "gamma_batch_mode.h"
 #include "gamma_interactive_mode.h"
+#include "command_stream.h"
+#include "batch_pipeline.h"
+#include "session_client.h"
+#include "session_server.h"
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+    // gamma -c plik: zapisuje polecenia z wejścia w postaci binarnej, gamma -r plik: odtwarza je,
+    // gamma -t: tryb wsadowy w osobnych wątkach, gamma -s gniazdo: serwer wielu gier,
+    // gamma -k gniazdo: klient serwera
+    if (argc == 3 && strcmp(argv[1], "-c") == 0) {
+        return command_stream_compile(argv[2]) ? 0 : 1;
+    } else if (argc == 3 && strcmp(argv[1], "-r") == 0) {
+        return command_stream_replay(argv[2]) ? 0 : 1;
+    } else if (argc == 3 && strcmp(argv[1], "-s") == 0) {
+        return session_server_run(argv[2]) ? 0 : 1;
+    } else if (argc == 3 && strcmp(argv[1], "-k") == 0) {
+        return session_client_run(argv[2]) ? 0 : 1;
+    }
 
-int main() {
     gamma_t *g = NULL;
     long long current_line_count = 0;
     int game_type = determine_game_type(&g, &current_line_count);
     if (game_type == BATCH) {
-        batch_read_input(g, current_line_count);
+        if (argc == 2 && strcmp(argv[1], "-t") == 0) {
+            batch_pipeline(g, current_line_count);
+        } else {
+            batch_read_input(g, current_line_count);
+        }
     } else if (game_type == INTERACTIVE) {
         interactive_play(g);
     }
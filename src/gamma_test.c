@@ -12,6 +12,7 @@
 #endif
 
 #include "gamma.h"
+#include "command_stream.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -93,6 +94,272 @@ int main() {
     printf(p);
     free(p);
 
+    p = gamma_board_region(g, 0, 0, 4, 2);
+    assert(p);
+    assert(strcmp(p, "1221\n1...\n") == 0);
+    free(p);
+    assert(gamma_board_region(g, 8, 0, 3, 1) == NULL);
+    assert(gamma_board_region(g, 0, 0, 0, 1) == NULL);
+
+    // odtworzony stan gry zachowuje się tak samo jak zapisany
+    assert(gamma_save(g, "gamma_test.snapshot"));
+    gamma_t *loaded = gamma_load("gamma_test.snapshot");
+    remove("gamma_test.snapshot");
+    assert(loaded != NULL);
+    p = gamma_board(loaded);
+    assert(p);
+    assert(strcmp(p, board) == 0);
+    free(p);
+    assert(gamma_busy_fields(loaded, 1) == 5);
+    assert(gamma_free_fields(loaded, 1) == 8);
+    assert(gamma_free_fields(loaded, 2) == 10);
+    assert(!gamma_golden_possible(loaded, 1));
+    assert(!gamma_golden_possible(loaded, 2));
+    assert(gamma_busy_fields(loaded, 2) == 4);
+    assert(gamma_hash(loaded) == gamma_hash(g));
+    assert(!gamma_move(loaded, 1, 9, 0));
+    gamma_delete(loaded);
+    assert(gamma_load("gamma_test.snapshot") == NULL);
+
+    // liczba zajętych pól, której iloczyn z rozmiarem opisu pola przekręca się
+    // do rozmiaru pliku, nie może prowadzić do czytania poza plikiem
+    struct {
+        char magic[8];
+        uint32_t version, width, height, players, areas, reserved;
+        uint64_t golden_used, busy_fields;
+        uint32_t fields[1020][3];
+    } snapshot = {{'G', 'A', 'M', 'M', 'A', 'S', 'A', 'V'}, GAMMA_SNAPSHOT_VERSION,
+                  UINT32_MAX, UINT32_MAX, 1, UINT32_MAX, 0, 0, (UINT64_C(1) << 62) + 1020, {{0}}};
+    for (uint32_t i = 0; i < 1020; i++) {
+        snapshot.fields[i][0] = 2 * i;
+        snapshot.fields[i][2] = 1;
+    }
+    FILE *file = fopen("gamma_test.snapshot", "wb");
+    assert(file != NULL);
+    assert(fwrite(&snapshot, sizeof(snapshot), 1, file) == 1);
+    fclose(file);
+    assert(gamma_load("gamma_test.snapshot") == NULL);
+    snapshot.busy_fields = 1020;
+    file = fopen("gamma_test.snapshot", "wb");
+    assert(file != NULL);
+    assert(fwrite(&snapshot, sizeof(snapshot), 1, file) == 1);
+    fclose(file);
+    loaded = gamma_load("gamma_test.snapshot");
+    remove("gamma_test.snapshot");
+    assert(loaded != NULL);
+    assert(gamma_busy_fields(loaded, 1) == 1020);
+    gamma_delete(loaded);
+
+    // ruchy na kopii nie zmieniają oryginału
+    gamma_t *clone = gamma_clone(g);
+    assert(clone != NULL);
+    assert(!gamma_undo(clone));
+    gamma_journal_enable(clone, true);
+    assert(gamma_hash(clone) == gamma_hash(g));
+    assert(gamma_move(clone, 1, 1, 9));
+    assert(gamma_hash(clone) != gamma_hash(g));
+    assert(gamma_busy_fields(clone, 1) == 6);
+    assert(gamma_busy_fields(g, 1) == 5);
+    p = gamma_board(g);
+    assert(p);
+    assert(strcmp(p, board) == 0);
+    free(p);
+
+    // cofnięty ruch nie zostawia śladu
+    assert(gamma_undo(clone));
+    assert(!gamma_undo(clone));
+    assert(gamma_hash(clone) == gamma_hash(g));
+    assert(gamma_busy_fields(clone, 1) == 5);
+    assert(gamma_free_fields(clone, 1) == 8);
+    p = gamma_board(clone);
+    assert(p);
+    assert(strcmp(p, board) == 0);
+    free(p);
+    gamma_delete(clone);
+
+    gamma_delete(g);
+
+    // skrót zależy od pozycji, a nie od kolejności ruchów
+    g = gamma_new(5, 5, 2, 2);
+    gamma_t *other = gamma_new(5, 5, 2, 2);
+    assert(g != NULL && other != NULL);
+    assert(gamma_hash(g) == gamma_hash(other));
+    assert(gamma_move(g, 1, 0, 0));
+    assert(gamma_move(g, 2, 4, 4));
+    assert(gamma_move(other, 2, 4, 4));
+    assert(gamma_hash(g) != gamma_hash(other));
+    assert(gamma_move(other, 1, 0, 0));
+    assert(gamma_hash(g) == gamma_hash(other));
+    assert(gamma_golden_move(g, 1, 4, 4));
+    assert(gamma_move(other, 1, 4, 3));
+    assert(gamma_hash(g) != gamma_hash(other));
+    gamma_delete(other);
+    gamma_delete(g);
+
+    // gracz na limicie obszarów może ruszyć się tylko obok swoich pól, a wynik
+    // nie zależy od tego, czy gra ma planszę bitową
+    field_position moves[4];
+    for (uint32_t players = 2; players <= 2 + BITBOARD_PLAYERS; players += BITBOARD_PLAYERS) {
+        g = gamma_new(5, 5, players, 1);
+        assert(g != NULL);
+        assert(gamma_legal_moves(g, 1, NULL, 0) == 25);
+        assert(gamma_move(g, 1, 2, 2));
+        assert(gamma_legal_moves(g, 1, moves, 4) == 4);
+        for (int i = 0; i < 4; i++) {
+            assert(abs((int)moves[i].x - 2) + abs((int)moves[i].y - 2) == 1);
+        }
+        assert(gamma_move(g, 2, 2, 3));
+        assert(gamma_legal_moves(g, 1, moves, 4) == 3);
+        assert(gamma_golden_legal_moves(g, 2, moves, 4) == 1);
+        assert(moves[0].x == 2 && moves[0].y == 2);
+        assert(gamma_golden_move(g, 2, 2, 2));
+        assert(gamma_golden_legal_moves(g, 2, moves, 4) == 0);
+        assert(gamma_legal_moves(g, 2, moves, 4) == 6);
+        gamma_delete(g);
+    }
+
+    // opisy graczy powstają dopiero przy ich pierwszym ruchu
+    g = gamma_new(3, 3, UINT32_MAX - 1, 1);
+    assert(g != NULL);
+    assert(!gamma_move(g, 0, 0, 0));
+    assert(!gamma_golden_move(g, 0, 0, 0));
+    assert(gamma_move(g, UINT32_MAX - 1, 1, 1));
+    assert(gamma_move(g, 4000000000u, 0, 1));
+    assert(gamma_busy_fields(g, 4000000000u) == 1);
+    assert(gamma_busy_fields(g, 7) == 0);
+    assert(gamma_free_fields(g, 7) == 7);
+    assert(gamma_golden_possible(g, 7));
+    assert(gamma_golden_possible(g, 4000000000u));
+    assert(gamma_golden_move(g, 4000000000u, 1, 1));
+    assert(gamma_busy_fields(g, UINT32_MAX - 1) == 0);
+    gamma_delete(g);
+
+    // największa plansza powstaje od razu, bo jej pola tworzone są dopiero przy ruchach
+    g = gamma_new(UINT32_MAX, UINT32_MAX, 2, 3);
+    assert(g != NULL);
+    assert(gamma_move(g, 1, 0, 0));
+    assert(gamma_move(g, 1, UINT32_MAX - 1, UINT32_MAX - 1));
+    assert(gamma_move(g, 1, 62, 63));
+    assert(!gamma_move(g, 1, 1000, 1000));
+    assert(gamma_move(g, 2, 64, 63));
+    assert(gamma_move(g, 2, 63, 64));
+    assert(gamma_move(g, 2, 63, 63));
+    gamma_journal_enable(g, true);
+    assert(gamma_golden_move(g, 1, 63, 63));
+    uint64_t hash = gamma_hash(g);
+    assert(gamma_undo(g));
+    assert(gamma_hash(g) != hash);
+    assert(gamma_golden_possible(g, 1));
+    assert(gamma_busy_fields(g, 2) == 3);
+    p = gamma_board_region(g, 62, 62, 4, 3);
+    assert(p);
+    assert(strcmp(p, ".2..\n122.\n....\n") == 0);
+    free(p);
+    assert(gamma_golden_move(g, 1, 63, 63));
+    assert(gamma_hash(g) == hash);
+    assert(gamma_busy_fields(g, 1) == 4);
+    assert(gamma_free_fields(g, 1) == 8);
+    assert(gamma_free_fields(g, 2) == (uint64_t)UINT32_MAX * UINT32_MAX - 6);
+    p = gamma_board_region(g, 62, 62, 4, 3);
+    assert(p);
+    assert(strcmp(p, ".2..\n112.\n....\n") == 0);
+    free(p);
+    assert(gamma_save(g, "gamma_test.snapshot"));
+    gamma_delete(g);
+    g = gamma_load("gamma_test.snapshot");
+    remove("gamma_test.snapshot");
+    assert(g != NULL);
+    assert(gamma_busy_fields(g, 1) == 4);
+    assert(gamma_free_fields(g, 1) == 8);
+    assert(!gamma_golden_possible(g, 1));
+    p = gamma_board_region(g, 62, 62, 4, 3);
+    assert(p);
+    assert(strcmp(p, ".2..\n112.\n....\n") == 0);
+    free(p);
+    gamma_delete(g);
+
+    // plansza z kafelkami wypisuje się tak samo jak zwykła
+    g = gamma_new(40000, 40000, 12, 1);
+    assert(g != NULL);
+    assert(gamma_move(g, 11, 0, 0));
+    assert(gamma_move(g, 3, 39999, 39999));
+    assert(gamma_move(g, 11, 1, 0));
+    p = gamma_board_region(g, 0, 0, 3, 2);
+    assert(p);
+    assert(strcmp(p, "...\n[11][11].\n") == 0);
+    free(p);
+    p = gamma_board_region(g, 39998, 39998, 2, 2);
+    assert(p);
+    assert(strcmp(p, ".3\n..\n") == 0);
+    free(p);
+    assert(gamma_busy_fields(g, 11) == 2);
+    assert(gamma_free_fields(g, 3) == 2);
+    gamma_delete(g);
+
+    // numery graczy powyżej 255 wymagają szerszych pól planszy
+    g = gamma_new(3, 2, 300, 2);
+    assert(g != NULL);
+    assert(gamma_move(g, 300, 0, 0));
+    assert(gamma_move(g, 255, 1, 0));
+    assert(gamma_golden_move(g, 256, 0, 0));
+    assert(gamma_busy_fields(g, 256) == 1);
+    assert(gamma_busy_fields(g, 300) == 0);
+    assert(gamma_free_fields(g, 255) == 4);
     gamma_delete(g);
+
+    // opisy obszarów nadążają za łączeniem, rozpadem i cofaniem ruchów
+    g = gamma_new(5, 3, 2, 3);
+    assert(g != NULL);
+    gamma_journal_enable(g, true);
+    region_info info, regions[3];
+    assert(!gamma_region_info(g, 0, 0, &info));
+    assert(gamma_move(g, 1, 0, 1));
+    assert(gamma_move(g, 1, 2, 1));
+    assert(gamma_region_info(g, 2, 1, &info));
+    assert(info.player == 1 && info.size == 1 && info.frontier == 4);
+    assert(gamma_move(g, 1, 1, 1));
+    assert(gamma_region_info(g, 0, 1, &info));
+    assert(info.size == 3 && info.frontier == 7);
+    assert(info.min_x == 0 && info.max_x == 2 && info.min_y == 1 && info.max_y == 1);
+    assert(gamma_move(g, 2, 1, 0));
+    assert(gamma_region_info(g, 0, 1, &info));
+    assert(info.frontier == 6);
+    assert(gamma_golden_move(g, 2, 1, 1));
+    assert(gamma_player_regions(g, 1, regions, 3) == 2);
+    assert(regions[0].size == 1 && regions[1].size == 1);
+    assert(regions[0].frontier + regions[1].frontier == 5);
+    assert(gamma_region_info(g, 1, 1, &info));
+    assert(info.player == 2 && info.size == 2 && info.min_y == 0 && info.max_y == 1);
+    assert(gamma_undo(g));
+    assert(gamma_player_regions(g, 1, NULL, 0) == 1);
+    assert(gamma_player_regions(g, 1, regions, 1) == 1);
+    assert(regions[0].size == 3 && regions[0].frontier == 6);
+    gamma_delete(g);
+
+    // wyzerowany rekord w pliku z poleceniami nie jest wykonywany jako p
+    struct {
+        command_stream_header header;
+        command_record records[2];
+    } stream;
+    memset(&stream, 0, sizeof(stream));
+    memcpy(stream.header.magic, "GAMMACMD", sizeof(stream.header.magic));
+    stream.header.version = COMMAND_STREAM_VERSION;
+    stream.header.record_size = sizeof(command_record);
+    stream.header.width = stream.header.height = stream.header.players = stream.header.areas = 1;
+    stream.header.record_count = 2;
+    stream.records[0].opcode = STREAM_GAME;
+    stream.records[0].arguments[0] = 1;
+    file = fopen("gamma_test.stream", "wb");
+    assert(file != NULL);
+    assert(fwrite(&stream, sizeof(stream), 1, file) == 1);
+    fclose(file);
+    assert(!command_stream_replay("gamma_test.stream"));
+    stream.records[1].opcode = 'p';
+    file = fopen("gamma_test.stream", "wb");
+    assert(file != NULL);
+    assert(fwrite(&stream, sizeof(stream), 1, file) == 1);
+    fclose(file);
+    assert(command_stream_replay("gamma_test.stream"));
+    remove("gamma_test.stream");
     return 0;
 }
@@ -6,6 +6,77 @@
  * @date 17.05.2020
  */
 #include "input.h"
+#include "output.h"
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Rozmiar bloku wczytywanego naraz z wejścia
+ */
+#define INPUT_BUFFER_SIZE (1 << 16)
+
+/** @brief Stan czytania wejścia.
+ */
+static struct {
+    const unsigned char *data;              ///< wczytany blok lub całe odwzorowane wejście
+    size_t length;                          ///< długość danych
+    size_t position;                        ///< pozycja następnego znaku
+    bool mapped;                            ///< true, jeśli wejście zostało odwzorowane w pamięci
+    bool started;                           ///< true, jeśli próbowano już odwzorować wejście
+    bool finished;                          ///< true, jeśli wejście się skończyło
+    unsigned char buffer[INPUT_BUFFER_SIZE]; ///< bufor na blok wejścia
+} input;
+
+/** @brief Uzupełnia dane wejścia, gdy wszystkie zostały przeczytane.
+ * Zwykły plik jest za pierwszym razem odwzorowywany w pamięci w całości,
+ * inne wejście jest czytane blokami.
+ * @return Wartość @p true, jeśli są nowe dane, a @p false, gdy wejście się skończyło.
+ */
+static bool refill_input(void) {
+    if (input.finished || input.mapped) {
+        input.finished = true;
+        return false;
+    }
+    if (!input.started) {
+        input.started = true;
+        struct stat status;
+        if (fstat(STDIN_FILENO, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+            void *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+            if (data != MAP_FAILED) {
+                input.data = data;
+                input.length = status.st_size;
+                input.position = 0;
+                input.mapped = true;
+                return true;
+            }
+        }
+    }
+    ssize_t length;
+    do {
+        length = read(STDIN_FILENO, input.buffer, INPUT_BUFFER_SIZE);
+    } while (length < 0 && errno == EINTR); // przerwanie sygnałem nie oznacza końca wejścia
+    if (length <= 0) {
+        input.finished = true;
+        return false;
+    }
+    input.data = input.buffer;
+    input.length = length;
+    input.position = 0;
+    return true;
+}
+
+int input_char(void) {
+    if (input.position == input.length && !refill_input()) {
+        return EOF;
+    }
+    return input.data[input.position++];
+}
+
+bool input_pending(void) {
+    return input.position < input.length;
+}
 
 static bool is_whitespace(int c) {
     return (c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r');
@@ -13,50 +84,41 @@ static bool is_whitespace(int c) {
 
 static void ignore_line(int *c, bool *end_of_input) {
     while (*c != EOF && *c != '\n') {
-        *c = getchar();
+        *c = input_char();
         if (*c == EOF)
             *end_of_input = true;
     }
 }
 
 /** @brief Wczytuje ciąg cyfr (tworzący liczbę) z wejścia, przekształca ją w liczbę
- *  Funkcja alokuje dynamicznie pamięć na wczytywany ciąg cyfr jednocześnie sprawdzając jego poprawność.
- *  Przekształca stworzoną tablicę znaków w unsigned long long po czym zwalnia pamięć.
+ *  Funkcja liczy wartość na bieżąco, jednocześnie sprawdzając poprawność ciągu.
+ *  Wartości większe od UINT32_MAX nie są dalej liczone, bo i tak są niepoprawne.
  * @param[in] *c   – wskaźnik na aktualny znak na wejściu,
  * @param[in] *correct_command  – wskaźnik na bool mówiący czy cała aktualna komenda jest do tej pory poprawna,
  * @param[in] *end_of_input - wskaźnik na bool mówiący czy natrafiono na EOF,
- * @return Wczytany argument polecenia w postaci unsigned long long
+ * @return Wczytany argument polecenia lub liczba większa od UINT32_MAX, gdy argument jest za duży
  */
-static unsigned long long get_argument(int *c, bool *correct_command, bool *end_of_input) {
-    char *argument_string = calloc(3, sizeof(char));
-    int i = 0;
-    int size = 3;
-    while (*c != EOF && *c != '\n' && !is_whitespace(*c) && !(*c < '0' || *c > '9')) {
-        if (i == size - 2) {
-            size = size * 3 / 2;
-            argument_string = realloc(argument_string, size);
+static uint64_t get_argument(int *c, bool *correct_command, bool *end_of_input) {
+    uint64_t argument = 0;
+    while (*c >= '0' && *c <= '9') {
+        if (argument <= UINT32_MAX) {
+            argument = argument * 10 + (*c - '0');
         }
-        argument_string[i] = *c;
-        i++;
-        *c = getchar();
+        *c = input_char();
         if (*c == EOF) {
             *end_of_input = true;
         }
         if (!is_whitespace(*c) && *c != '\n' && (*c < '0' || *c > '9')) {
             *correct_command = false;
-            free(argument_string);
             return 0;
         }
     }
-    argument_string[i] = '\0';
-    unsigned long long argument = strtoull(argument_string, NULL, 10);
-    free(argument_string);
     return argument;
 }
 
-int *get_command(gamma_t *g, bool *correct_command, bool *end_of_input) {
-    int *command = NULL;
-    int c = getchar();
+bool get_command(gamma_t *g, command *current, bool *correct_command, bool *end_of_input) {
+    bool command_read = false;
+    int c = input_char();
     if (c == EOF) {
         *end_of_input = true;
     } else if (c == '#' || c == '\n') {
@@ -67,7 +129,7 @@ int *get_command(gamma_t *g, bool *correct_command, bool *end_of_input) {
     } else if (c != 'B' && c != 'I' && c != 'm' && c != 'g' && c != 'b' && c != 'f' && c != 'q' && c != 'p') {
         *correct_command = false;
         while (c != EOF && c != '\n') {
-            c = getchar();
+            c = input_char();
             if (c == EOF) {
                 *end_of_input = true;
             }
@@ -83,36 +145,34 @@ int *get_command(gamma_t *g, bool *correct_command, bool *end_of_input) {
         } else {
             arg_count = 1;
         }
-        command = calloc(arg_count, sizeof(int));
-        command[0] = c;
+        command_read = true;
+        current->type = c;
         int i = 1;
-        c = getchar();
+        c = input_char();
 
         if (arg_count > 1 && !is_whitespace(c)) { // musi być whitespace po pierwszym znaku
             *correct_command = false;
             ignore_line(&c, end_of_input);
-            free(command);
-            return NULL;
+            return false;
         }
 
         while (c != EOF && c != '\n') {
             while (is_whitespace(c)) {
-                c = getchar();
+                c = input_char();
             }
             if (c != '\n') {
                 if (!*correct_command || (c < '0' || c > '9') || i >= arg_count) {
                     *correct_command = false;
                     ignore_line(&c, end_of_input);
-                    free(command);
-                    command = NULL;
+                    command_read = false;
                     break;
                 } else {
-                    unsigned long long arg = get_argument(&c, correct_command, end_of_input);
+                    uint64_t arg = get_argument(&c, correct_command, end_of_input);
                     if (arg <= UINT32_MAX) { // wartość mieści się w dopuszczalnym zakresie
-                        command[i] = (int) arg;
+                        current->arguments[i - 1] = arg;
                         i++;
                         if (c != EOF && c != '\n')
-                            c = getchar();
+                            c = input_char();
                     } else {
                         *correct_command = false;
                     }
@@ -121,50 +181,49 @@ int *get_command(gamma_t *g, bool *correct_command, bool *end_of_input) {
         }
         if (*correct_command && i != arg_count) {  // za mało argumentów
             *correct_command = false;
-            free(command);
-            command = NULL;
+            command_read = false;
         }
     }
-    return command;
+    return command_read;
 }
 
 int determine_game_type(gamma_t **g, long long *current_line_count) {
     bool end_of_input = false;
+    command current;
     while (!end_of_input) {
         bool correct_command = true;
 
-        int *command = get_command(*g, &correct_command, &end_of_input);
+        bool command_read = get_command(*g, &current, &correct_command, &end_of_input);
         (*current_line_count)++;
 
-        if (!(correct_command && command == NULL)) { // jeżeli prawda to komentarz/wiersz pusty
-            if (!correct_command || (command[0] != 'B' && command[0] != 'I')) {
-                fprintf(stderr, "ERROR %lld\n", *current_line_count);
+        if (!(correct_command && !command_read)) { // jeżeli prawda to komentarz/wiersz pusty
+            if (!correct_command || (current.type != 'B' && current.type != 'I')) {
+                output_error(*current_line_count);
             } else {
-                for (int i = 1; i <= 4; i++) {
-                    if (command[i] <= 0)
+                for (int i = 0; i < MAX_ARGUMENTS; i++) {
+                    // argument większy od INT32_MAX jako int byłby ujemny
+                    if (current.arguments[i] == 0 || current.arguments[i] > INT32_MAX)
                         correct_command = false;
                 }
                 if (correct_command) {
-                    *g = gamma_new(command[1], command[2], command[3], command[4]);
+                    *g = gamma_new(current.arguments[0], current.arguments[1],
+                                   current.arguments[2], current.arguments[3]);
                     if (*g != NULL) {
-                        if (command[0] == 'B') {
-                            printf("OK %lld\n", *current_line_count);
-                            free(command);
+                        if (current.type == 'B') {
+                            output_bytes("OK ", sizeof("OK ") - 1);
+                            output_number(*current_line_count);
+                            output_char('\n');
                             return BATCH;
-                        } else if (command[0] == 'I') {
-                            free(command);
+                        } else if (current.type == 'I') {
+                            output_flush(); // dalej wypisuje tryb interaktywny
                             return INTERACTIVE;
                         }
                     }
                 } else {
-                    fprintf(stderr, "ERROR %lld\n", *current_line_count);
+                    output_error(*current_line_count);
                 }
             }
         }
-
-        if (command != NULL) {
-            free(command);
-        }
     }
     return 0;
 }
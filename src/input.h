@@ -1,34 +1,60 @@
-/** @file
- * Interfejs klasy pomocniczej do wczytywania wejścia.
- *
- * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
- * @copyright Uniwersytet Warszawski
- * @date 17.05.2020
- */
-
-#include "gamma.h"
-#include <stdio.h>
-
-#ifndef GAMMA_INPUT_H
-#define GAMMA_INPUT_H
-
-#define BATCH 1
-#define INTERACTIVE 2
-
-/** @brief Wczytuje pojedyncze polecenie z wejścia.
- * @param[in] *g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] *correct_command  – wskaźnik na bool mówiący czy cała aktualna komenda jest do tej pory poprawna,
- * @param[in] *end_of_input - wskaźnik na bool mówiący czy natrafiono na EOF,
- * @return <=5 elementowa tablica int reprezentująca wczytaną komendę lub NULL
- */
-int *get_command(gamma_t *g, bool *correct_command, bool *end_of_input);
-
-
-/** @brief Wczytuje wejście i determinuje jaki typ rozgrywki wybrał użytkownik.
- * @param[in, out] **g   – wskaźnik na wskaźnik na strukturę przechowującą stan gry,
- * @param[in, out] *current_line_count - wskaźnik na liczbę dotychczasowo wczytanych linijek wejścia,
- * @return int = 1 lub 2, odpowiednio zdefiniowane jako tryby BATCH lub INTERACTIVE
- */
-int determine_game_type(gamma_t **g, long long *current_line_count);
-
-#endif //GAMMA_INPUT_H
+/** @file
+ * Interfejs klasy pomocniczej do wczytywania wejścia.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 17.05.2020
+ */
+
+#include "gamma.h"
+#include <stdio.h>
+
+#ifndef GAMMA_INPUT_H
+#define GAMMA_INPUT_H
+
+#define BATCH 1
+#define INTERACTIVE 2
+
+/**
+ * Największa liczba argumentów polecenia
+ */
+#define MAX_ARGUMENTS 4
+
+/** @brief Wczytane polecenie.
+ */
+typedef struct {
+    int type;                          ///< litera polecenia
+    uint32_t arguments[MAX_ARGUMENTS]; ///< kolejne argumenty polecenia
+} command;
+
+/** @brief Wczytuje jeden znak z wejścia.
+ * Wejście jest czytane dużymi blokami (lub, gdy jest zwykłym plikiem, odwzorowane
+ * w pamięci), więc wszystkie odczyty wejścia muszą przechodzić przez tę funkcję.
+ * @return Wczytany znak lub EOF, gdy wejście się skończyło.
+ */
+int input_char(void);
+
+/** @brief Sprawdza, czy w buforze wejścia są jeszcze wczytane znaki.
+ * @return Wartość @p true, jeśli następne wywołanie @ref input_char nie będzie czekać na wejście.
+ */
+bool input_pending(void);
+
+/** @brief Wczytuje pojedyncze polecenie z wejścia.
+ * @param[in] *g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] *current – wskaźnik na miejsce na wczytane polecenie,
+ * @param[in] *correct_command  – wskaźnik na bool mówiący czy cała aktualna komenda jest do tej pory poprawna,
+ * @param[in] *end_of_input - wskaźnik na bool mówiący czy natrafiono na EOF,
+ * @return true, jeśli wczytano polecenie (być może niepoprawne), false dla komentarza, pustego wiersza
+ * lub polecenia odrzuconego w całości
+ */
+bool get_command(gamma_t *g, command *current, bool *correct_command, bool *end_of_input);
+
+
+/** @brief Wczytuje wejście i determinuje jaki typ rozgrywki wybrał użytkownik.
+ * @param[in, out] **g   – wskaźnik na wskaźnik na strukturę przechowującą stan gry,
+ * @param[in, out] *current_line_count - wskaźnik na liczbę dotychczasowo wczytanych linijek wejścia,
+ * @return int = 1 lub 2, odpowiednio zdefiniowane jako tryby BATCH lub INTERACTIVE
+ */
+int determine_game_type(gamma_t **g, long long *current_line_count);
+
+#endif //GAMMA_INPUT_H
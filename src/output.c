@@ -0,0 +1,113 @@
+/** @file
+ * Implementacja klasy pomocniczej do buforowanego wypisywania wyników.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "output.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * Rozmiar bufora wyjścia
+ */
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+/**
+ * Najdłuższy zapis dziesiętny liczby 64-bitowej
+ */
+#define NUMBER_DIGITS 20
+
+/**
+ * Bufor standardowego wyjścia
+ */
+static char buffer[OUTPUT_BUFFER_SIZE];
+
+/**
+ * Liczba bajtów w buforze
+ */
+static size_t buffered = 0;
+
+/** @brief Wypisuje w całości ciągi bajtów opisane tablicą @p parts.
+ * Powtarza wypisywanie po częściowym zapisie lub przerwaniu przez sygnał.
+ * @return Wartość @p true, jeśli się udało, a @p false wpp.
+ */
+static bool write_all(int fd, struct iovec *parts, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        while (count > 0 && (size_t)written >= parts->iov_len) {
+            written -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0) {
+            parts->iov_base = (char *)parts->iov_base + written;
+            parts->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+void output_bytes(const char *data, size_t length) {
+    if (buffered + length <= OUTPUT_BUFFER_SIZE) {
+        for (size_t i = 0; i < length; i++) {
+            buffer[buffered + i] = data[i];
+        }
+        buffered += length;
+        return;
+    }
+    // długi ciąg wypisujemy razem z buforem bez kopiowania
+    struct iovec parts[2] = {{buffer, buffered}, {(void *)data, length}};
+    write_all(STDOUT_FILENO, parts, 2);
+    buffered = 0;
+}
+
+void output_char(char c) {
+    if (buffered == OUTPUT_BUFFER_SIZE) {
+        output_flush();
+    }
+    buffer[buffered++] = c;
+}
+
+/** @brief Zapisuje liczbę w zapisie dziesiętnym tuż przed miejscem @p end.
+ * @return wskaźnik na pierwszą cyfrę zapisu
+ */
+static char *format_number(uint64_t value, char *end) {
+    do {
+        *--end = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    return end;
+}
+
+void output_number(uint64_t value) {
+    char digits[NUMBER_DIGITS];
+    char *first = format_number(value, digits + NUMBER_DIGITS);
+    output_bytes(first, digits + NUMBER_DIGITS - first);
+}
+
+void output_flush(void) {
+    struct iovec part = {buffer, buffered};
+    write_all(STDOUT_FILENO, &part, 1);
+    buffered = 0;
+}
+
+void output_error(long long line) {
+    output_flush();
+    char digits[NUMBER_DIGITS + 1];
+    digits[NUMBER_DIGITS] = '\n';
+    char *first = format_number(line, digits + NUMBER_DIGITS);
+    struct iovec parts[2] = {{(void *)"ERROR ", sizeof("ERROR ") - 1},
+                             {first, digits + NUMBER_DIGITS + 1 - first}};
+    write_all(STDERR_FILENO, parts, 2);
+}
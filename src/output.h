@@ -0,0 +1,43 @@
+/** @file
+ * Interfejs klasy pomocniczej do buforowanego wypisywania wyników.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_OUTPUT_H
+#define GAMMA_OUTPUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Dopisuje ciąg bajtów do wyjścia.
+ * Krótkie ciągi trafiają do bufora, długie są wypisywane od razu razem z nim.
+ * @param[in] *data  – wskaźnik na ciąg bajtów,
+ * @param[in] length – długość ciągu.
+ */
+void output_bytes(const char *data, size_t length);
+
+/** @brief Dopisuje jeden znak do wyjścia.
+ * @param[in] c – wypisywany znak.
+ */
+void output_char(char c);
+
+/** @brief Dopisuje do wyjścia liczbę w zapisie dziesiętnym.
+ * @param[in] value – wypisywana liczba.
+ */
+void output_number(uint64_t value);
+
+/** @brief Wypisuje zawartość bufora na standardowe wyjście.
+ */
+void output_flush(void);
+
+/** @brief Wypisuje na standardowe wyjście błędów komunikat o błędzie w wierszu.
+ * Bufor standardowego wyjścia jest najpierw opróżniany, żeby komunikaty
+ * pojawiały się w tej samej kolejności co wyniki poleceń.
+ * @param[in] line – numer wiersza z błędem.
+ */
+void output_error(long long line);
+
+#endif /* GAMMA_OUTPUT_H */
@@ -0,0 +1,137 @@
+/** @file
+ * Implementacja tablicy graczy tworzącej opisy graczy dopiero przy pierwszym użyciu.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "player_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Liczba graczy na jednej stronie
+ */
+#define PAGE_SIZE (UINT32_C(1) << PLAYER_PAGE_BITS)
+
+/**
+ * Maksymalna liczba stron w jednym bloku
+ */
+#define BLOCK_SIZE (UINT32_C(1) << PLAYER_BLOCK_BITS)
+
+/**
+ * Opis gracza, który jeszcze nic nie zrobił
+ */
+static const player initial_player = {
+        .busy_fields = 0,
+        .free_fields = 0,
+        .areas = 0,
+        .golden_unused = true,
+        .golden_targets = 0,
+        .safe_golden_targets = 0,
+};
+
+/** @brief Podaje liczbę stron w bloku o danym numerze.
+ * Ostatni blok ma tylko tyle stron, ile potrzeba na pozostałych graczy.
+ */
+static uint32_t block_pages(const player_table *table, uint32_t block) {
+    uint64_t pages = ((uint64_t)table->count + PAGE_SIZE - 1) / PAGE_SIZE - (uint64_t)block * BLOCK_SIZE;
+    return pages < BLOCK_SIZE ? pages : BLOCK_SIZE;
+}
+
+bool player_table_init(player_table *table, uint32_t count) {
+    table->count = count;
+    table->block_count = ((uint64_t)count + PAGE_SIZE * BLOCK_SIZE - 1) / (PAGE_SIZE * BLOCK_SIZE);
+    table->blocks = calloc(table->block_count, sizeof(player **));
+    return table->blocks != NULL;
+}
+
+void player_table_destroy(player_table *table) {
+    for (uint32_t block = 0; block < table->block_count; block++) {
+        if (table->blocks[block] != NULL) {
+            for (uint32_t page = 0; page < block_pages(table, block); page++) {
+                free(table->blocks[block][page]);
+            }
+            free(table->blocks[block]);
+        }
+    }
+    free(table->blocks);
+    table->blocks = NULL;
+    table->block_count = 0;
+}
+
+bool player_table_copy(player_table *copy, const player_table *table) {
+    if (!player_table_init(copy, table->count)) {
+        copy->block_count = 0;
+        return false;
+    }
+    for (uint32_t block = 0; block < table->block_count; block++) {
+        if (table->blocks[block] == NULL) {
+            continue;
+        }
+        copy->blocks[block] = calloc(block_pages(table, block), sizeof(player *));
+        if (copy->blocks[block] == NULL) {
+            return false;
+        }
+        for (uint32_t page = 0; page < block_pages(table, block); page++) {
+            if (table->blocks[block][page] != NULL) {
+                copy->blocks[block][page] = malloc(PAGE_SIZE * sizeof(player));
+                if (copy->blocks[block][page] == NULL) {
+                    return false;
+                }
+                memcpy(copy->blocks[block][page], table->blocks[block][page], PAGE_SIZE * sizeof(player));
+            }
+        }
+    }
+    return true;
+}
+
+const player *player_table_get(const player_table *table, uint32_t number) {
+    uint32_t index = number - 1;
+    player **block = table->blocks[index / (PAGE_SIZE * BLOCK_SIZE)];
+    if (block == NULL) {
+        return &initial_player;
+    }
+    player *page = block[index / PAGE_SIZE % BLOCK_SIZE];
+    if (page == NULL) {
+        return &initial_player;
+    }
+    return &page[index % PAGE_SIZE];
+}
+
+player *player_table_touch(player_table *table, uint32_t number) {
+    uint32_t index = number - 1;
+    uint32_t block = index / (PAGE_SIZE * BLOCK_SIZE);
+    if (table->blocks[block] == NULL) {
+        table->blocks[block] = calloc(block_pages(table, block), sizeof(player *));
+        if (table->blocks[block] == NULL) {
+            return NULL;
+        }
+    }
+    player **page = &table->blocks[block][index / PAGE_SIZE % BLOCK_SIZE];
+    if (*page == NULL) {
+        *page = malloc(PAGE_SIZE * sizeof(player));
+        if (*page == NULL) {
+            return NULL;
+        }
+        for (uint32_t i = 0; i < PAGE_SIZE; i++) {
+            (*page)[i] = initial_player;
+        }
+    }
+    return &(*page)[index % PAGE_SIZE];
+}
+
+uint32_t player_table_next(const player_table *table, uint32_t number) {
+    for (uint64_t index = (uint64_t)number - 1; index < table->count;) {
+        player **block = table->blocks[index / (PAGE_SIZE * BLOCK_SIZE)];
+        if (block == NULL) {
+            index = (index / (PAGE_SIZE * BLOCK_SIZE) + 1) * (PAGE_SIZE * BLOCK_SIZE);
+        } else if (block[index / PAGE_SIZE % BLOCK_SIZE] == NULL) {
+            index = (index / PAGE_SIZE + 1) * PAGE_SIZE;
+        } else {
+            return index + 1;
+        }
+    }
+    return 0;
+}
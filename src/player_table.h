@@ -0,0 +1,107 @@
+/** @file
+ * Interfejs tablicy graczy tworzącej opisy graczy dopiero przy pierwszym użyciu.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_PLAYER_TABLE_H
+#define GAMMA_PLAYER_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Struktura jednego gracza.
+ * Trzyma niezbędne informacje o danym graczu.
+ */
+typedef struct {
+    uint64_t busy_fields; ///< ilość pól zajętych przez gracza, liczba nieujemna
+    uint64_t free_fields; ///< ilość wolnych pól sąsiadujących z polami gracza, liczba nieujemna
+    uint32_t areas;       ///< ile obszarów tworzą zajęte przez gracza pola, liczba nieujemna
+    bool golden_unused;   ///< true jeżeli gracz nie użył jeszcze złotego ruchu, false wpp
+    uint64_t golden_targets;      ///< ilość pól innych graczy sąsiadujących z polami gracza
+    uint64_t safe_golden_targets; ///< ile z nich można odebrać bez rozspójnienia obszaru właściciela
+} player;
+
+/**
+ * Liczba bitów numeru gracza wybierających miejsce na stronie
+ */
+#define PLAYER_PAGE_BITS 8
+
+/**
+ * Liczba bitów numeru gracza wybierających stronę w bloku
+ */
+#define PLAYER_BLOCK_BITS 12
+
+/** @brief Tablica graczy podzielona na strony.
+ * Strona opisów graczy powstaje dopiero przy pierwszym zapisie do któregoś z nich,
+ * a blok wskaźników na strony – przy utworzeniu pierwszej jego strony.
+ * Gracz, którego strona nie istnieje, ma opis początkowy.
+ */
+typedef struct {
+    player ***blocks;     ///< bloki wskaźników na strony, NULL dla nieużywanych bloków
+    uint32_t block_count; ///< rozmiar tablicy @p blocks
+    uint32_t count;       ///< liczba graczy
+} player_table;
+
+/** @brief Inicjuje tablicę, w której wszyscy gracze mają opis początkowy.
+ * @param[out] table  – wskaźnik na inicjowaną tablicę,
+ * @param[in] count   – liczba graczy, liczba dodatnia.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci.
+ */
+bool player_table_init(player_table *table, uint32_t count);
+
+/** @brief Zwalnia pamięć zajmowaną przez tablicę.
+ * @param[in,out] table – wskaźnik na tablicę.
+ */
+void player_table_destroy(player_table *table);
+
+/** @brief Tworzy kopię tablicy graczy.
+ * Kopiowane są tylko utworzone strony.
+ * @param[out] copy  – wskaźnik na inicjowaną kopię,
+ * @param[in] table  – wskaźnik na kopiowaną tablicę.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci
+ * (wtedy kopię trzeba zwolnić przez @ref player_table_destroy).
+ */
+bool player_table_copy(player_table *copy, const player_table *table);
+
+/** @brief Podaje opis gracza do odczytu.
+ * @param[in] table   – wskaźnik na tablicę,
+ * @param[in] number  – numer gracza, liczba dodatnia niewiększa od liczby graczy.
+ * @return Wskaźnik na opis gracza lub na wspólny opis początkowy.
+ */
+const player *player_table_get(const player_table *table, uint32_t number);
+
+/** @brief Podaje opis gracza do zapisu, tworząc go w razie potrzeby.
+ * @param[in,out] table – wskaźnik na tablicę,
+ * @param[in] number    – numer gracza, liczba dodatnia niewiększa od liczby graczy.
+ * @return Wskaźnik na opis gracza lub NULL, gdy zabrakło pamięci.
+ */
+player *player_table_touch(player_table *table, uint32_t number);
+
+/** @brief Znajduje następnego gracza z utworzonym opisem.
+ * Pomija całe nieutworzone strony i bloki, więc przejście wszystkich opisów
+ * kosztuje tyle, ile jest utworzonych stron, a nie graczy.
+ * @param[in] table   – wskaźnik na tablicę,
+ * @param[in] number  – numer gracza, od którego zaczyna się szukanie, liczba dodatnia,
+ *                      może przekraczać liczbę graczy.
+ * @return Najmniejszy numer gracza niemniejszy od @p number, który ma utworzony opis,
+ * lub 0, jeśli takiego gracza nie ma.
+ */
+uint32_t player_table_next(const player_table *table, uint32_t number);
+
+/** @brief Podaje istniejący opis gracza do zapisu.
+ * Opis musi być wcześniej utworzony przez @ref player_table_touch.
+ * @param[in,out] table – wskaźnik na tablicę,
+ * @param[in] number    – numer gracza, liczba dodatnia niewiększa od liczby graczy.
+ * @return Wskaźnik na opis gracza.
+ */
+static inline player *player_table_at(player_table *table, uint32_t number) {
+    uint32_t index = number - 1;
+    return &table->blocks[index >> (PLAYER_PAGE_BITS + PLAYER_BLOCK_BITS)]
+                         [(index >> PLAYER_PAGE_BITS) & ((UINT32_C(1) << PLAYER_BLOCK_BITS) - 1)]
+                         [index & ((UINT32_C(1) << PLAYER_PAGE_BITS) - 1)];
+}
+
+#endif /* GAMMA_PLAYER_TABLE_H */
@@ -0,0 +1,124 @@
+/** @file
+ * Implementacja klienta serwera wielu rozgrywek.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 17.10.2026
+ */
+
+#define _GNU_SOURCE ///< udostępnia MSG_NOSIGNAL przy kompilacji z -std=c11
+
+#include "session_client.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * Rozmiar buforów klienta
+ */
+#define CLIENT_BUFFER_SIZE (1 << 16)
+
+/** @brief Wypisuje w całości ciąg bajtów na standardowe wyjście.
+ * @return Wartość @p true, jeśli się udało, a @p false wpp.
+ */
+static bool write_all(const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+/** @brief Łączy się z gniazdem lokalnym.
+ * @return deskryptor gniazda w trybie nieblokującym lub -1, gdy się nie udało
+ */
+static int connect_server(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    // łączymy się w trybie blokującym, dalej zapis i odczyt czekają w poll
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool session_client_run(const char *path) {
+    int fd = connect_server(path);
+    if (fd < 0) {
+        return false;
+    }
+    static char request[CLIENT_BUFFER_SIZE];
+    static char reply[CLIENT_BUFFER_SIZE];
+    size_t request_start = 0, request_length = 0;
+    bool end_of_input = false;
+    bool connected = true;
+    bool correct = true;
+
+    while (connected && correct) {
+        struct pollfd descriptors[2];
+        descriptors[0].fd = fd;
+        descriptors[0].events = POLLIN | (request_start < request_length ? POLLOUT : 0);
+        descriptors[1].fd = STDIN_FILENO;
+        descriptors[1].events = POLLIN;
+        // nowe dane z wejścia dopiero po wysłaniu poprzednich
+        nfds_t count = !end_of_input && request_start == request_length ? 2 : 1;
+        if (poll(descriptors, count, -1) < 0) {
+            correct = errno == EINTR;
+            continue;
+        }
+
+        if (descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t length = read(fd, reply, CLIENT_BUFFER_SIZE);
+            if (length > 0) {
+                correct = write_all(reply, length);
+            } else if (length == 0) {
+                connected = false;
+            } else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+                correct = false;
+            }
+        }
+        if (correct && connected && (descriptors[0].revents & POLLOUT)) {
+            ssize_t written = send(fd, request + request_start, request_length - request_start, MSG_NOSIGNAL);
+            if (written > 0) {
+                request_start += written;
+            } else if (written < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+                correct = false;
+            }
+        }
+        if (correct && count == 2 && (descriptors[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+            ssize_t length = read(STDIN_FILENO, request, CLIENT_BUFFER_SIZE);
+            if (length > 0) {
+                request_start = 0;
+                request_length = length;
+            } else if (length == 0 || errno != EINTR) {
+                // serwer kończy odpowiadać po otrzymaniu końca wejścia
+                end_of_input = true;
+                shutdown(fd, SHUT_WR);
+            }
+        }
+    }
+    close(fd);
+    return correct && end_of_input && request_start == request_length;
+}
@@ -0,0 +1,25 @@
+/** @file
+ * Interfejs klienta serwera wielu rozgrywek.
+ * Klient przesyła serwerowi standardowe wejście i wypisuje na standardowe
+ * wyjście wszystko, co serwer odpowie. Służy do ręcznego i skryptowego
+ * sprawdzania serwera.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 17.10.2026
+ */
+
+#ifndef GAMMA_SESSION_CLIENT_H
+#define GAMMA_SESSION_CLIENT_H
+
+#include <stdbool.h>
+
+/** @brief Łączy się z serwerem i przekazuje mu standardowe wejście.
+ * Po końcu wejścia czeka, aż serwer wyśle wszystkie wyniki i zamknie połączenie.
+ * @param[in] *path – ścieżka do gniazda serwera.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy nie dało się połączyć
+ * lub połączenie zostało zerwane.
+ */
+bool session_client_run(const char *path);
+
+#endif /* GAMMA_SESSION_CLIENT_H */
@@ -0,0 +1,756 @@
+/** @file
+ * Implementacja serwera wielu rozgrywek nasłuchującego na gnieździe lokalnym.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 17.10.2026
+ */
+
+#define _GNU_SOURCE ///< udostępnia accept4, epoll_pwait i MSG_NOSIGNAL przy kompilacji z -std=c11
+
+#include "session_server.h"
+#include "field_map.h"
+#include "input.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * Rozmiar bufora wejścia połączenia, dłuższe wiersze są błędne
+ */
+#define SESSION_INPUT_SIZE 4096
+
+/**
+ * Liczba niewysłanych bajtów, po której serwer wstrzymuje wykonywanie poleceń połączenia
+ */
+#define SESSION_OUTPUT_LIMIT (1 << 16)
+
+/**
+ * Najmniejszy rozmiar bufora wyjścia połączenia
+ */
+#define SESSION_OUTPUT_MIN 256
+
+/**
+ * Największa liczba zdarzeń odbieranych naraz z pętli zdarzeń
+ */
+#define SESSION_EVENTS 64
+
+/**
+ * Długość kolejki połączeń oczekujących na przyjęcie
+ */
+#define SESSION_BACKLOG 64
+
+/**
+ * Najmniejsza liczba miejsc na gry
+ */
+#define SESSION_MIN_SLOTS 16
+
+/**
+ * Największa liczba pól planszy opisywanych naraz dla polecenia p
+ */
+#define SESSION_RENDER_FIELDS 4096
+
+/**
+ * Litera polecenia usuwającego grę
+ */
+#define SESSION_DELETE 'D'
+
+/**
+ * Najdłuższy zapis dziesiętny liczby 64-bitowej
+ */
+#define NUMBER_DIGITS 20
+
+/** @brief Stan jednego połączenia.
+ */
+typedef struct session {
+    int fd;                           ///< deskryptor gniazda połączenia
+    uint32_t events;                  ///< zdarzenia, na które połączenie czeka w pętli zdarzeń
+    long long line;                   ///< liczba wierszy wczytanych z połączenia
+    size_t input_start;               ///< pozycja pierwszego nieprzetworzonego bajtu wejścia
+    size_t input_length;              ///< liczba bajtów w buforze wejścia
+    bool discarding;                  ///< true, jeśli odrzucana jest reszta za długiego wiersza
+    bool end_of_input;                ///< true, jeśli klient zakończył wysyłanie
+    bool failed;                      ///< true, jeśli połączenie trzeba zamknąć natychmiast
+    bool paused;                      ///< true, jeśli wykonywanie poleceń czeka na wysłanie wyników
+    bool rendering;                   ///< true, jeśli plansza jest jeszcze wypisywana
+    uint32_t render_slot;             ///< miejsce gry, której plansza jest wypisywana
+    uint32_t render_rows;             ///< liczba wierszy planszy, które nie zostały wypisane w całości
+    uint32_t render_x;                ///< pierwsza niewypisana kolumna bieżącego wiersza
+    char *output;                     ///< bufor wyjścia, NULL gdy pusty
+    size_t output_start;              ///< pozycja pierwszego niewysłanego bajtu wyjścia
+    size_t output_length;             ///< liczba bajtów w buforze wyjścia
+    size_t output_capacity;           ///< rozmiar bufora wyjścia
+    struct session *previous;         ///< poprzednie połączenie na liście połączeń
+    struct session *next;             ///< następne połączenie na liście połączeń
+    char input[SESSION_INPUT_SIZE];   ///< bufor wejścia
+} session;
+
+/** @brief Miejsce na grę.
+ */
+typedef struct {
+    gamma_t *g;        ///< gra, NULL dla wolnego miejsca
+    uint32_t width;    ///< szerokość planszy gry
+    uint32_t height;   ///< wysokość planszy gry
+    uint32_t readers;  ///< liczba połączeń wypisujących planszę tej gry
+    bool deleted;      ///< true, jeśli grę usunięto, ale jej plansza jest jeszcze wypisywana
+} game_slot;
+
+/** @brief Stan serwera.
+ */
+typedef struct {
+    int epoll_fd;          ///< deskryptor pętli zdarzeń
+    int listen_fd;         ///< deskryptor gniazda nasłuchującego
+    field_map games;       ///< przypisuje numerom gier indeksy w tablicy @p slots
+    game_slot *slots;      ///< miejsca na gry
+    uint32_t *free_slots;  ///< stos indeksów wolnych miejsc
+    uint32_t slot_count;   ///< liczba kiedykolwiek użytych miejsc
+    uint32_t slot_capacity;///< rozmiar tablic @p slots i @p free_slots
+    uint32_t free_count;   ///< liczba indeksów na stosie wolnych miejsc
+    session *sessions;     ///< lista otwartych połączeń
+} server;
+
+/**
+ * Ustawiana przez obsługę sygnałów SIGINT i SIGTERM
+ */
+static volatile sig_atomic_t stop_requested = 0;
+
+/** @brief Obsługa sygnałów kończących pracę serwera.
+ */
+static void request_stop(int signal) {
+    (void)signal;
+    stop_requested = 1;
+}
+
+/** @brief Dopisuje bajty do bufora wyjścia połączenia.
+ * Gdy zabraknie pamięci, połączenie zostanie zamknięte.
+ * @param[in,out] c    – wskaźnik na połączenie,
+ * @param[in] data     – dopisywane bajty,
+ * @param[in] length   – liczba bajtów.
+ */
+static void session_output(session *c, const char *data, size_t length) {
+    if (c->failed) {
+        return;
+    }
+    if (c->output_length + length > c->output_capacity && c->output_start > 0) {
+        memmove(c->output, c->output + c->output_start, c->output_length - c->output_start);
+        c->output_length -= c->output_start;
+        c->output_start = 0;
+    }
+    if (c->output_length + length > c->output_capacity) {
+        size_t capacity = c->output_capacity < SESSION_OUTPUT_MIN ? SESSION_OUTPUT_MIN : c->output_capacity;
+        while (c->output_length + length > capacity) {
+            capacity *= 2;
+        }
+        char *output = realloc(c->output, capacity);
+        if (output == NULL) {
+            c->failed = true;
+            return;
+        }
+        c->output = output;
+        c->output_capacity = capacity;
+    }
+    memcpy(c->output + c->output_length, data, length);
+    c->output_length += length;
+}
+
+/** @brief Dopisuje znak do bufora wyjścia połączenia.
+ */
+static void session_output_char(session *c, char character) {
+    session_output(c, &character, 1);
+}
+
+/** @brief Dopisuje liczbę w zapisie dziesiętnym do bufora wyjścia połączenia.
+ */
+static void session_output_number(session *c, uint64_t value) {
+    char digits[NUMBER_DIGITS];
+    char *first = digits + NUMBER_DIGITS;
+    do {
+        *--first = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    session_output(c, first, digits + NUMBER_DIGITS - first);
+}
+
+/** @brief Dopisuje odpowiedź z numerem bieżącego wiersza, na przykład "OK 3".
+ */
+static void session_reply(session *c, const char *reply) {
+    session_output(c, reply, strlen(reply));
+    session_output_char(c, ' ');
+    session_output_number(c, c->line);
+    session_output_char(c, '\n');
+}
+
+/** @brief Przekazuje fragment opisu planszy do bufora wyjścia połączenia.
+ */
+static void session_board(const char *data, size_t length, void *context) {
+    session_output(context, data, length);
+}
+
+static bool is_whitespace(char c) {
+    return (c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r');
+}
+
+/** @brief Pomija białe znaki wiersza.
+ * @return wskaźnik na pierwszy znak niebędący białym znakiem lub @p end
+ */
+static const char *skip_whitespace(const char *c, const char *end) {
+    while (c < end && is_whitespace(*c)) {
+        c++;
+    }
+    return c;
+}
+
+/** @brief Wczytuje liczbę zaczynającą się w miejscu @p *c.
+ * Tak jak w trybie wsadowym po liczbie musi wystąpić biały znak lub koniec wiersza.
+ * @param[in,out] c  – wskaźnik na bieżącą pozycję w wierszu, przesuwany za liczbę,
+ * @param[in] end    – koniec wiersza,
+ * @param[out] value – wskaźnik na miejsce na liczbę.
+ * @return Wartość @p true, jeśli wczytano liczbę nie większą od UINT32_MAX, a @p false wpp.
+ */
+static bool parse_number(const char **c, const char *end, uint32_t *value) {
+    const char *digit = *c;
+    if (digit == end || *digit < '0' || *digit > '9') {
+        return false;
+    }
+    uint64_t number = 0;
+    for (; digit < end && *digit >= '0' && *digit <= '9'; digit++) {
+        number = number * 10 + (*digit - '0');
+        if (number > UINT32_MAX) {
+            return false;
+        }
+    }
+    if (digit < end && !is_whitespace(*digit)) {
+        return false;
+    }
+    *value = number;
+    *c = digit;
+    return true;
+}
+
+/** @brief Podaje liczbę argumentów polecenia.
+ * @return liczba argumentów lub -1, gdy litera nie oznacza polecenia serwera
+ */
+static int argument_count(char type) {
+    if (type == 'B') {
+        return 4;
+    } else if (type == 'm' || type == 'g') {
+        return 3;
+    } else if (type == 'b' || type == 'f' || type == 'q') {
+        return 1;
+    } else if (type == 'p' || type == SESSION_DELETE) {
+        return 0;
+    }
+    return -1;
+}
+
+/** @brief Wczytuje numer gry i polecenie z wiersza.
+ * @param[in] c         – początek wiersza,
+ * @param[in] end       – koniec wiersza, bez znaku końca wiersza,
+ * @param[out] game     – wskaźnik na miejsce na numer gry,
+ * @param[out] current  – wskaźnik na miejsce na polecenie.
+ * @return Wartość @p true, jeśli wiersz jest poprawny, a @p false wpp.
+ */
+static bool parse_line(const char *c, const char *end, uint32_t *game, command *current) {
+    if (!parse_number(&c, end, game)) {
+        return false;
+    }
+    c = skip_whitespace(c, end);
+    if (c == end) {
+        return false;
+    }
+    int count = argument_count(*c);
+    if (count < 0) {
+        return false;
+    }
+    current->type = *c++;
+    if (count > 0 && (c == end || !is_whitespace(*c))) { // musi być whitespace po literze polecenia
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        c = skip_whitespace(c, end);
+        if (!parse_number(&c, end, &current->arguments[i])) {
+            return false;
+        }
+    }
+    return skip_whitespace(c, end) == end;
+}
+
+/** @brief Tworzy grę o numerze @p id.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy gra o tym numerze istnieje,
+ * argumenty są niepoprawne lub zabrakło pamięci.
+ */
+static bool server_create(server *s, uint32_t id, const command *current) {
+    for (int i = 0; i < MAX_ARGUMENTS; i++) {
+        // argument większy od INT32_MAX jako int byłby ujemny
+        if (current->arguments[i] == 0 || current->arguments[i] > INT32_MAX) {
+            return false;
+        }
+    }
+    if (field_map_get(&s->games, id, NULL) || !field_map_reserve(&s->games, 1)) {
+        return false;
+    }
+    if (s->free_count == 0 && s->slot_count == s->slot_capacity) {
+        if (s->slot_capacity > UINT32_MAX / 2) {
+            return false;
+        }
+        uint32_t capacity = s->slot_capacity < SESSION_MIN_SLOTS ? SESSION_MIN_SLOTS : 2 * s->slot_capacity;
+        game_slot *slots = realloc(s->slots, capacity * sizeof(*slots));
+        if (slots == NULL) {
+            return false;
+        }
+        s->slots = slots;
+        uint32_t *free_slots = realloc(s->free_slots, capacity * sizeof(*free_slots));
+        if (free_slots == NULL) {
+            return false;
+        }
+        s->free_slots = free_slots;
+        s->slot_capacity = capacity;
+    }
+    gamma_t *g = gamma_new(current->arguments[0], current->arguments[1],
+                           current->arguments[2], current->arguments[3]);
+    if (g == NULL) {
+        return false;
+    }
+    uint32_t slot = s->free_count > 0 ? s->free_slots[--s->free_count] : s->slot_count++;
+    s->slots[slot].g = g;
+    s->slots[slot].width = current->arguments[0];
+    s->slots[slot].height = current->arguments[1];
+    s->slots[slot].readers = 0;
+    s->slots[slot].deleted = false;
+    field_map_set(&s->games, id, slot);
+    return true;
+}
+
+/** @brief Zwalnia miejsce @p slot razem z grą.
+ */
+static void server_release(server *s, uint32_t slot) {
+    gamma_delete(s->slots[slot].g);
+    s->slots[slot].g = NULL;
+    s->free_slots[s->free_count++] = slot;
+}
+
+/** @brief Usuwa grę o numerze @p id zajmującą miejsce @p slot.
+ * Gra, której plansza jest jeszcze wypisywana, znika od razu z tablicy gier,
+ * a jej pamięć jest zwalniana po zakończeniu wypisywania.
+ */
+static void server_delete(server *s, uint32_t id, uint32_t slot) {
+    field_map_remove(&s->games, id);
+    if (s->slots[slot].readers > 0) {
+        s->slots[slot].deleted = true;
+    } else {
+        server_release(s, slot);
+    }
+}
+
+/** @brief Rozpoczyna wypisywanie planszy gry z miejsca @p slot.
+ * Plansza jest opisywana kawałkami w miarę wysyłania wyników, więc nawet
+ * dla największych plansz bufor wyjścia nie przekracza kilkudziesięciu kilobajtów,
+ * a pętla zdarzeń obsługuje w międzyczasie inne połączenia.
+ */
+static void session_render_start(server *s, session *c, uint32_t slot) {
+    s->slots[slot].readers++;
+    c->rendering = true;
+    c->render_slot = slot;
+    c->render_rows = s->slots[slot].height;
+    c->render_x = 0;
+}
+
+/** @brief Kończy wypisywanie planszy, także przerwane zamknięciem połączenia.
+ */
+static void session_render_end(server *s, session *c) {
+    game_slot *slot = &s->slots[c->render_slot];
+    c->rendering = false;
+    if (--slot->readers == 0 && slot->deleted) {
+        server_release(s, c->render_slot);
+    }
+}
+
+/** @brief Dopisuje do bufora wyjścia kolejny kawałek planszy.
+ * Kawałek to co najwyżej @ref SESSION_RENDER_FIELDS pól jednego wiersza.
+ * Wiersz wypisany w całości kończy się znakiem końca wiersza, jak w trybie wsadowym.
+ */
+static void session_render(server *s, session *c) {
+    game_slot *slot = &s->slots[c->render_slot];
+    uint32_t fields = slot->width - c->render_x;
+    if (fields > SESSION_RENDER_FIELDS) {
+        fields = SESSION_RENDER_FIELDS;
+    }
+    gamma_board_region_write(slot->g, c->render_x, c->render_rows - 1, fields, 1, session_board, c);
+    c->render_x += fields;
+    if (c->render_x < slot->width) {
+        if (!c->failed) {
+            c->output_length--; // znak końca wiersza dopisze dopiero ostatni kawałek
+        }
+    } else {
+        c->render_x = 0;
+        if (--c->render_rows == 0) {
+            session_render_end(s, c);
+        }
+    }
+}
+
+/** @brief Wykonuje polecenie trybu wsadowego i dopisuje jego wynik do bufora wyjścia.
+ * Polecenie p jedynie rozpoczyna wypisywanie planszy.
+ */
+static void session_command(server *s, session *c, uint32_t slot, const command *current) {
+    gamma_t *g = s->slots[slot].g;
+    const uint32_t *argument = current->arguments;
+
+    if (current->type == 'm') {
+        session_output_char(c, '0' + gamma_move(g, argument[0], argument[1], argument[2]));
+        session_output_char(c, '\n');
+    } else if (current->type == 'g') {
+        session_output_char(c, '0' + gamma_golden_move(g, argument[0], argument[1], argument[2]));
+        session_output_char(c, '\n');
+    } else if (current->type == 'b') {
+        session_output_number(c, gamma_busy_fields(g, argument[0]));
+        session_output_char(c, '\n');
+    } else if (current->type == 'f') {
+        session_output_number(c, gamma_free_fields(g, argument[0]));
+        session_output_char(c, '\n');
+    } else if (current->type == 'q') {
+        session_output_char(c, '0' + gamma_golden_possible(g, argument[0]));
+        session_output_char(c, '\n');
+    } else {
+        session_render_start(s, c, slot);
+    }
+}
+
+/** @brief Obsługuje jeden wiersz wejścia połączenia.
+ * @param[in,out] s – wskaźnik na serwer,
+ * @param[in,out] c – wskaźnik na połączenie,
+ * @param[in] line  – początek wiersza,
+ * @param[in] length – długość wiersza bez znaku końca wiersza.
+ */
+static void session_execute(server *s, session *c, const char *line, size_t length) {
+    if (length == 0 || line[0] == '#') { // komentarz lub pusta
+        return;
+    }
+    uint32_t id, slot;
+    command current;
+    if (!parse_line(line, line + length, &id, &current)) {
+        session_reply(c, "ERROR");
+    } else if (current.type == 'B') {
+        session_reply(c, server_create(s, id, &current) ? "OK" : "ERROR");
+    } else if (!field_map_get(&s->games, id, &slot)) {
+        session_reply(c, "ERROR");
+    } else if (current.type == SESSION_DELETE) {
+        server_delete(s, id, slot);
+        session_reply(c, "OK");
+    } else {
+        session_command(s, c, slot, &current);
+    }
+}
+
+/** @brief Sprawdza, czy połączenie ma za dużo niewysłanych wyników, by wykonywać dalsze polecenia.
+ */
+static bool session_blocked(const session *c) {
+    return c->output_length - c->output_start >= SESSION_OUTPUT_LIMIT;
+}
+
+/** @brief Wykonuje wczytane w całości wiersze połączenia.
+ * Przerywa, gdy bufor wyjścia jest pełny, a resztę wykona po wysłaniu wyników.
+ * Dopóki plansza jest wypisywana, kolejne polecenia czekają, więc wyniki zachowują kolejność.
+ * Ustawia @p paused, jeśli przerwano z powodu pełnego bufora wyjścia.
+ */
+static void session_process(server *s, session *c) {
+    while (!c->failed && !session_blocked(c) && (c->rendering || c->input_start < c->input_length)) {
+        if (c->rendering) {
+            session_render(s, c);
+            continue;
+        }
+        char *begin = c->input + c->input_start;
+        size_t available = c->input_length - c->input_start;
+        char *newline = memchr(begin, '\n', available);
+        size_t length = newline != NULL ? (size_t)(newline - begin) : available;
+        if (newline != NULL) {
+            c->input_start += length + 1;
+        } else if (c->end_of_input || c->discarding) { // ostatni wiersz bez znaku końca lub reszta za długiego
+            c->input_start += length;
+        } else if (available == SESSION_INPUT_SIZE) { // za długi wiersz, resztę odrzucamy
+            c->line++;
+            session_reply(c, "ERROR");
+            c->discarding = true;
+            c->input_start += length;
+            continue;
+        } else {
+            break;
+        }
+        if (c->discarding) {
+            c->discarding = newline == NULL && !c->end_of_input;
+        } else {
+            c->line++;
+            session_execute(s, c, begin, length);
+        }
+    }
+    c->paused = !c->failed && session_blocked(c) && (c->rendering || c->input_start < c->input_length);
+    if (c->input_start == c->input_length) {
+        c->input_start = 0;
+        c->input_length = 0;
+    }
+}
+
+/** @brief Wczytuje dostępne dane z połączenia.
+ */
+static void session_read(session *c) {
+    if (c->input_start > 0) {
+        memmove(c->input, c->input + c->input_start, c->input_length - c->input_start);
+        c->input_length -= c->input_start;
+        c->input_start = 0;
+    }
+    if (c->input_length == SESSION_INPUT_SIZE) { // wiersz zostanie odrzucony przy przetwarzaniu
+        return;
+    }
+    ssize_t length;
+    do {
+        length = read(c->fd, c->input + c->input_length, SESSION_INPUT_SIZE - c->input_length);
+    } while (length < 0 && errno == EINTR);
+    if (length > 0) {
+        c->input_length += length;
+    } else if (length == 0) {
+        c->end_of_input = true;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        c->failed = true;
+    }
+}
+
+/** @brief Wysyła jak najwięcej wyników bez czekania.
+ * Pusty bufor wyjścia większy niż @ref SESSION_OUTPUT_LIMIT jest zwalniany,
+ * żeby bezczynne połączenie zajmowało mało pamięci.
+ */
+static void session_write(session *c) {
+    while (c->output_start < c->output_length) {
+        ssize_t written = send(c->fd, c->output + c->output_start,
+                               c->output_length - c->output_start, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                c->failed = true;
+            }
+            return;
+        }
+        c->output_start += written;
+    }
+    c->output_start = 0;
+    c->output_length = 0;
+    if (c->output_capacity > SESSION_OUTPUT_LIMIT) {
+        free(c->output);
+        c->output = NULL;
+        c->output_capacity = 0;
+    }
+}
+
+/** @brief Zamyka połączenie i zwalnia jego pamięć.
+ */
+static void session_close(server *s, session *c) {
+    close(c->fd); // zamknięcie deskryptora usuwa go z pętli zdarzeń
+    if (c->rendering) {
+        session_render_end(s, c);
+    }
+    if (c->previous != NULL) {
+        c->previous->next = c->next;
+    } else {
+        s->sessions = c->next;
+    }
+    if (c->next != NULL) {
+        c->next->previous = c->previous;
+    }
+    free(c->output);
+    free(c);
+}
+
+/** @brief Ustawia zdarzenia, na które połączenie czeka w pętli zdarzeń.
+ * Połączenie z pełnym buforem wyjścia nie jest czytane, dopóki klient nie odbierze wyników.
+ * Wstrzymane połączenie czeka na możliwość zapisu także z pustym buforem wyjścia,
+ * więc dokończy pracę w następnym obrocie pętli, po obsłużeniu innych połączeń.
+ */
+static void session_update_events(server *s, session *c) {
+    uint32_t events = 0;
+    if (!c->end_of_input && !session_blocked(c)) {
+        events |= EPOLLIN;
+    }
+    if (c->output_start < c->output_length || c->paused) {
+        events |= EPOLLOUT;
+    }
+    if (events != c->events) {
+        struct epoll_event event = {.events = events, .data.ptr = c};
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, c->fd, &event) != 0) {
+            c->failed = true;
+        }
+        c->events = events;
+    }
+}
+
+/** @brief Obsługuje zdarzenia połączenia.
+ */
+static void session_handle(server *s, session *c, uint32_t events) {
+    if (events & EPOLLERR) {
+        c->failed = true;
+    }
+    if (!c->failed && (events & EPOLLOUT)) {
+        session_write(c);
+    }
+    if (!c->failed && !c->end_of_input && (events & (EPOLLIN | EPOLLHUP))) {
+        session_read(c);
+    }
+    if (!c->failed) {
+        session_process(s, c);
+        session_write(c);
+    }
+    if (!c->failed) {
+        session_update_events(s, c);
+    }
+    if (c->failed || (c->end_of_input && c->input_start == c->input_length && !c->rendering &&
+                      c->output_start == c->output_length)) {
+        session_close(s, c);
+    }
+}
+
+/** @brief Przyjmuje oczekujące połączenia.
+ */
+static void server_accept(server *s) {
+    for (;;) {
+        int fd = accept4(s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        session *c = malloc(sizeof(*c));
+        if (c == NULL) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+        c->line = 0;
+        c->input_start = 0;
+        c->input_length = 0;
+        c->discarding = false;
+        c->end_of_input = false;
+        c->failed = false;
+        c->paused = false;
+        c->rendering = false;
+        c->output = NULL;
+        c->output_start = 0;
+        c->output_length = 0;
+        c->output_capacity = 0;
+        struct epoll_event event = {.events = c->events, .data.ptr = c};
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->previous = NULL;
+        c->next = s->sessions;
+        if (s->sessions != NULL) {
+            s->sessions->previous = c;
+        }
+        s->sessions = c;
+    }
+}
+
+/** @brief Zamyka wszystkie połączenia i usuwa wszystkie gry.
+ */
+static void server_destroy(server *s) {
+    while (s->sessions != NULL) {
+        session_close(s, s->sessions);
+    }
+    for (uint32_t i = 0; i < s->slot_count; i++) {
+        gamma_delete(s->slots[i].g);
+    }
+    free(s->slots);
+    free(s->free_slots);
+    field_map_destroy(&s->games);
+    close(s->epoll_fd);
+    close(s->listen_fd);
+}
+
+/** @brief Obsługuje zdarzenia aż do otrzymania sygnału kończącego.
+ * Sygnały są odblokowane tylko w czasie czekania na zdarzenia, więc żaden nie zginie.
+ * @param[in,out] s      – wskaźnik na serwer,
+ * @param[in] *wait_mask – maska sygnałów na czas czekania.
+ * @return Wartość @p true, jeśli pętla skończyła się na żądanie, a @p false po błędzie.
+ */
+static bool server_loop(server *s, const sigset_t *wait_mask) {
+    struct epoll_event events[SESSION_EVENTS];
+    while (!stop_requested) {
+        int count = epoll_pwait(s->epoll_fd, events, SESSION_EVENTS, -1, wait_mask);
+        if (count < 0 && errno != EINTR) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr == NULL) {
+                server_accept(s);
+            } else {
+                session_handle(s, events[i].data.ptr, events[i].events);
+            }
+        }
+    }
+    return true;
+}
+
+bool session_server_run(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    server s;
+    memset(&s, 0, sizeof(s));
+    field_map_init(&s.games);
+    s.listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s.listen_fd < 0) {
+        return false;
+    }
+    if (bind(s.listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(s.listen_fd);
+        return false;
+    }
+    s.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (listen(s.listen_fd, SESSION_BACKLOG) != 0 || s.epoll_fd < 0 ||
+        epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, s.listen_fd, &event) != 0) {
+        if (s.epoll_fd >= 0) {
+            close(s.epoll_fd);
+        }
+        close(s.listen_fd);
+        unlink(path);
+        return false;
+    }
+
+    sigset_t stop_signals, original_mask, wait_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &stop_signals, &original_mask);
+    struct sigaction action, old_interrupt, old_terminate;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &old_interrupt);
+    sigaction(SIGTERM, &action, &old_terminate);
+    wait_mask = original_mask;
+    sigdelset(&wait_mask, SIGINT);
+    sigdelset(&wait_mask, SIGTERM);
+
+    bool stopped = server_loop(&s, &wait_mask);
+
+    sigaction(SIGINT, &old_interrupt, NULL);
+    sigaction(SIGTERM, &old_terminate, NULL);
+    sigprocmask(SIG_SETMASK, &original_mask, NULL);
+    server_destroy(&s);
+    unlink(path);
+    return stopped;
+}
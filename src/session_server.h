@@ -0,0 +1,40 @@
+/** @file
+ * Interfejs serwera wielu rozgrywek nasłuchującego na gnieździe lokalnym.
+ * Serwer przechowuje w jednym procesie dowolnie wiele gier, a połączenia
+ * obsługuje w jednej pętli zdarzeń (epoll), więc każda gra i każde połączenie
+ * kosztuje jedynie pamięć ich struktur.
+ *
+ * Wiersze przesyłane przez klienta mają postać <tt>numer_gry polecenie</tt>,
+ * gdzie polecenie jest poleceniem trybu wsadowego. Polecenie B tworzy grę
+ * o podanym numerze, a polecenie D (bez argumentów) ją usuwa; na oba serwer
+ * odpowiada <tt>OK numer_wiersza</tt>. Pozostałe polecenia dotyczą istniejącej
+ * gry i dają takie same wyniki jak w trybie wsadowym. Błędne wiersze są
+ * zgłaszane w tym samym strumieniu komunikatem <tt>ERROR numer_wiersza</tt>.
+ * Wiersze są numerowane osobno w każdym połączeniu, a gry są wspólne dla
+ * wszystkich połączeń.
+ *
+ * Plansza dla polecenia p jest opisywana kawałkami w miarę odbierania wyników
+ * przez klienta, a dalsze polecenia połączenia czekają do końca jej wypisania.
+ * Polecenia innych połączeń mogą w tym czasie zmieniać tę samą grę, więc
+ * dalsze wiersze planszy pokazują stan z chwili ich wypisania.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 17.10.2026
+ */
+
+#ifndef GAMMA_SESSION_SERVER_H
+#define GAMMA_SESSION_SERVER_H
+
+#include <stdbool.h>
+
+/** @brief Uruchamia serwer na gnieździe lokalnym.
+ * Działa do otrzymania sygnału SIGINT lub SIGTERM, po czym usuwa gniazdo
+ * i wszystkie gry.
+ * @param[in] *path – ścieżka, pod którą ma powstać gniazdo, nie może być zajęta.
+ * @return Wartość @p true, jeśli serwer zakończył się na żądanie, a @p false,
+ * gdy nie dało się utworzyć gniazda lub pętli zdarzeń.
+ */
+bool session_server_run(const char *path);
+
+#endif /* GAMMA_SESSION_SERVER_H */
@@ -0,0 +1,123 @@
+/** @file
+ * Implementacja bufora cyklicznego dla jednego producenta i jednego konsumenta.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#define _XOPEN_SOURCE 700 ///< udostępnia sched_yield przy kompilacji z -std=c11
+
+#include "spsc_ring.h"
+#include <sched.h>
+#include <stdlib.h>
+
+/**
+ * Liczba prób przed oddaniem procesora innym wątkom
+ */
+#define SPIN_LIMIT 64
+
+/**
+ * Liczba prób, po której czekająca strona zasypia
+ */
+#define SLEEP_LIMIT 128
+
+bool spsc_ring_init(spsc_ring *ring, size_t capacity, size_t element_size) {
+    ring->slots = malloc(capacity * element_size);
+    if (ring->slots == NULL) {
+        return false;
+    }
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    ring->head_seen = 0;
+    ring->tail_seen = 0;
+    ring->element_size = element_size;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->waiting, 0);
+    if (pthread_mutex_init(&ring->lock, NULL) != 0) {
+        free(ring->slots);
+        ring->slots = NULL;
+        return false;
+    }
+    if (pthread_cond_init(&ring->changed, NULL) != 0) {
+        pthread_mutex_destroy(&ring->lock);
+        free(ring->slots);
+        ring->slots = NULL;
+        return false;
+    }
+    return true;
+}
+
+void spsc_ring_destroy(spsc_ring *ring) {
+    pthread_cond_destroy(&ring->changed);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+/** @brief Budzi drugą stronę, jeśli śpi w oczekiwaniu na zmianę bufora.
+ * Bariera porządkuje zmianę licznika przed odczytem liczby śpiących, a śpiący
+ * ma taką samą barierę między zwiększeniem tej liczby a sprawdzeniem licznika,
+ * więc co najmniej jedna strona widzi zmianę drugiej i powiadomienie nie ginie.
+ */
+static void wake_waiting(spsc_ring *ring) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->waiting, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&ring->lock);
+        pthread_cond_broadcast(&ring->changed);
+        pthread_mutex_unlock(&ring->lock);
+    }
+}
+
+/** @brief Ponawia operację na buforze, aż się powiedzie.
+ * Najpierw próbuje od razu, potem oddaje procesor innym wątkom, a w końcu
+ * zasypia do czasu powiadomienia przez drugą stronę.
+ * @param[in,out] ring    – wskaźnik na bufor,
+ * @param[in,out] element – wskaźnik na element,
+ * @param[in] attempt     – @ref spsc_ring_try_push lub @ref spsc_ring_try_pop.
+ */
+static void retry(spsc_ring *ring, void *element, bool (*attempt)(spsc_ring *, void *)) {
+    for (int tries = 0; tries < SLEEP_LIMIT; tries++) {
+        if (attempt(ring, element)) {
+            return;
+        }
+        if (tries >= SPIN_LIMIT) {
+            sched_yield();
+        }
+    }
+    pthread_mutex_lock(&ring->lock);
+    atomic_fetch_add(&ring->waiting, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    // druga strona budzi pod blokadą, więc nie zdąży tego zrobić między sprawdzeniem a uśpieniem
+    while (!attempt(ring, element)) {
+        pthread_cond_wait(&ring->changed, &ring->lock);
+    }
+    atomic_fetch_sub(&ring->waiting, 1);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/** @brief Próbuje zapisać element, dostosowana do @ref retry.
+ */
+static bool attempt_push(spsc_ring *ring, void *element) {
+    return spsc_ring_try_push(ring, element);
+}
+
+/** @brief Próbuje odczytać element, dostosowana do @ref retry.
+ */
+static bool attempt_pop(spsc_ring *ring, void *element) {
+    return spsc_ring_try_pop(ring, element);
+}
+
+void spsc_ring_push(spsc_ring *ring, const void *element) {
+    if (!spsc_ring_try_push(ring, element)) {
+        retry(ring, (void *)element, attempt_push);
+    }
+    wake_waiting(ring);
+}
+
+void spsc_ring_pop(spsc_ring *ring, void *element) {
+    if (!spsc_ring_try_pop(ring, element)) {
+        retry(ring, element, attempt_pop);
+    }
+    wake_waiting(ring);
+}
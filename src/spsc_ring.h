@@ -0,0 +1,109 @@
+/** @file
+ * Interfejs bufora cyklicznego dla jednego producenta i jednego konsumenta.
+ * Producent i konsument działają w osobnych wątkach i nie używają blokad,
+ * wymieniają się jedynie licznikami zapisanych i odczytanych elementów.
+ * Strona, która długo czeka na drugą, zasypia na zmiennej warunkowej,
+ * więc bezczynny bufor nie zajmuje procesora.
+ *
+ * @author Adrian Matwiejuk <am418419@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_SPSC_RING_H
+#define GAMMA_SPSC_RING_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * Rozmiar linii pamięci podręcznej, liczniki obu stron leżą w osobnych liniach
+ */
+#define RING_CACHE_LINE 64
+
+/** @brief Bufor cykliczny elementów stałego rozmiaru.
+ */
+typedef struct {
+    alignas(RING_CACHE_LINE) atomic_size_t tail; ///< liczba zapisanych elementów, zmienia ją tylko producent
+    size_t head_seen;                            ///< ostatnio odczytana przez producenta wartość @p head
+    alignas(RING_CACHE_LINE) atomic_size_t head; ///< liczba odczytanych elementów, zmienia ją tylko konsument
+    size_t tail_seen;                            ///< ostatnio odczytana przez konsumenta wartość @p tail
+    alignas(RING_CACHE_LINE) char *slots;        ///< miejsca na elementy
+    size_t element_size;                         ///< rozmiar elementu w bajtach
+    size_t mask;                                 ///< liczba miejsc pomniejszona o 1, liczba miejsc jest potęgą dwójki
+    atomic_int waiting;                          ///< liczba wątków uśpionych w oczekiwaniu na drugą stronę
+    pthread_mutex_t lock;                        ///< blokada, pod którą strony zasypiają i są budzone
+    pthread_cond_t changed;                      ///< sygnalizowana po zapisie lub odczycie, gdy ktoś śpi
+} spsc_ring;
+
+/** @brief Tworzy pusty bufor.
+ * @param[out] ring       – wskaźnik na inicjowany bufor,
+ * @param[in] capacity    – liczba miejsc, potęga dwójki,
+ * @param[in] element_size – rozmiar elementu w bajtach.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy zabrakło pamięci
+ * lub nie dało się utworzyć blokady.
+ */
+bool spsc_ring_init(spsc_ring *ring, size_t capacity, size_t element_size);
+
+/** @brief Zwalnia pamięć zajmowaną przez bufor.
+ * @param[in,out] ring – wskaźnik na bufor.
+ */
+void spsc_ring_destroy(spsc_ring *ring);
+
+/** @brief Próbuje zapisać element, może ją wywoływać tylko producent.
+ * Nie budzi konsumenta uśpionego w @ref spsc_ring_pop.
+ * @param[in,out] ring – wskaźnik na bufor,
+ * @param[in] element  – wskaźnik na zapisywany element.
+ * @return Wartość @p true, jeśli element został zapisany, a @p false, gdy bufor jest pełny.
+ */
+static inline bool spsc_ring_try_push(spsc_ring *ring, const void *element) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (tail - ring->head_seen > ring->mask) {
+        ring->head_seen = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail - ring->head_seen > ring->mask) {
+            return false;
+        }
+    }
+    memcpy(ring->slots + (tail & ring->mask) * ring->element_size, element, ring->element_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/** @brief Próbuje odczytać element, może ją wywoływać tylko konsument.
+ * Nie budzi producenta uśpionego w @ref spsc_ring_push.
+ * @param[in,out] ring – wskaźnik na bufor,
+ * @param[out] element – wskaźnik na miejsce na odczytany element.
+ * @return Wartość @p true, jeśli element został odczytany, a @p false, gdy bufor jest pusty.
+ */
+static inline bool spsc_ring_try_pop(spsc_ring *ring, void *element) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head == ring->tail_seen) {
+        ring->tail_seen = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head == ring->tail_seen) {
+            return false;
+        }
+    }
+    memcpy(element, ring->slots + (head & ring->mask) * ring->element_size, ring->element_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+/** @brief Zapisuje element, czekając na wolne miejsce.
+ * Budzi konsumenta, jeśli czeka na element.
+ * @param[in,out] ring – wskaźnik na bufor,
+ * @param[in] element  – wskaźnik na zapisywany element.
+ */
+void spsc_ring_push(spsc_ring *ring, const void *element);
+
+/** @brief Odczytuje element, czekając aż się pojawi.
+ * Budzi producenta, jeśli czeka na wolne miejsce.
+ * @param[in,out] ring – wskaźnik na bufor,
+ * @param[out] element – wskaźnik na miejsce na odczytany element.
+ */
+void spsc_ring_pop(spsc_ring *ring, void *element);
+
+#endif /* GAMMA_SPSC_RING_H */